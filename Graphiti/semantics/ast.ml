@@ -24,6 +24,8 @@ type expr =
   | OpAssign of string * op * expr
   | GraphEdges of expr * expr
   | GraphNodes of expr * expr
+  | GraphInNodes of expr * expr
+  | GraphLabelNodes of expr * expr * expr
   | GraphAllNodes of expr
   | GraphAll of expr
   | GraphAddVertex of expr
@@ -127,6 +129,8 @@ let rec string_of_expr =
   | GraphLit(l) -> "{{" ^ String.concat "," (List.map (fun(e) -> string_of_expr e) l) ^ "}}"
   | GraphMod(id, l) -> id ^ "{{" ^ String.concat "," (List.map (fun(e) -> string_of_expr e) l) ^ "}}"
   | GraphNodes(id, n) -> string_of_expr id ^ ".get_neighbors(" ^ string_of_expr n ^ ")"
+  | GraphInNodes(id, n) -> string_of_expr id ^ ".get_in_neighbors(" ^ string_of_expr n ^ ")"
+  | GraphLabelNodes(id, n, l) -> string_of_expr id ^ ".get_neighbors_by_label(" ^ string_of_expr n ^ ", " ^ string_of_expr l ^ ")"
   | GraphEdges(id, e) -> string_of_expr id ^ ".get_edges(" ^ string_of_expr e ^ ")"
   | GraphAllNodes(id) -> string_of_expr id ^ ".get_all_nodes()"
   | GraphAll(id) -> string_of_expr id ^ ".get_all_nodes()"
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "graph.h"
+
+/*
+ * Scaling benchmark for parallel_bfs.
+ * Usage: ./bench [vertices] [average degree] [max threads]
+ * Builds a random graph, then times bfs and parallel_bfs from
+ * vertex 0 with 1, 2, 4, ... threads up to the maximum.
+ */
+
+static double seconds() {
+
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+
+	int n = argc > 1 ? atoi(argv[1]) : 1000000;
+	int degree = argc > 2 ? atoi(argv[2]) : 8;
+	int max_threads = argc > 3 ? atoi(argv[3]) : 8;
+
+	struct graph *g = new_graph();
+	struct map **v = malloc(n * sizeof(struct map *));
+	struct map **from = malloc(n * sizeof(struct map *));
+	struct map **to = malloc(n * sizeof(struct map *));
+	char **data = malloc(n * sizeof(char *));
+	int i, d;
+
+	srand(42);
+	for (i = 0; i < n; ++i) {
+		v[i] = make_map();
+		add_vertex(g, v[i]);
+		data[i] = "";
+	}
+	/* pass d links each vertex to a random one in the d-th band of
+	 * following ids, so no edge is added twice */
+	int band = n / degree;
+	for (d = 0; d < degree; ++d) {
+		for (i = 0; i < n; ++i) {
+			from[i] = v[i];
+			to[i] = v[(i + 1 + d * band + rand() % (band - 1)) % n];
+		}
+		add_batch(g, from, data, to, n);
+	}
+
+	double start = seconds();
+	freeze_graph(g);
+	printf("%d vertices, %d edges, frozen in %.3fs\n",
+		n, g->edge_count, seconds() - start);
+
+	start = seconds();
+	struct traversal *t = bfs(g, v[0]);
+	double serial = seconds() - start;
+	printf("bfs: %d reached in %.3fs\n", t->count, serial);
+	free_traversal(t);
+
+	int threads;
+	for (threads = 1; threads <= max_threads; threads *= 2) {
+		graph_set_threads(threads);
+		start = seconds();
+		t = parallel_bfs(g, v[0]);
+		double elapsed = seconds() - start;
+		printf("parallel_bfs, %d thread%s: %d reached in %.3fs (%.2fx)\n",
+			threads, threads > 1 ? "s" : "", t->count, elapsed, serial / elapsed);
+		free_traversal(t);
+	}
+
+	return 0;
+}
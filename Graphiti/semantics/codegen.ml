@@ -30,6 +30,12 @@ let first_element (myList) = match myList with
  [] -> Void
 | first_e1 :: _ -> get_type(first_e1)
 
+(* FNV-1a hash of a string, as the runtime computes it *)
+let string_hash s =
+  let h = ref 0x811c9dc5 in
+  String.iter (fun c -> h := ((!h lxor C.code c) * 0x01000193) land 0xffffffff) s;
+  !h
+
 let check_list_type m =
 	let (t, _) = m in 
 	match t with
@@ -65,6 +71,9 @@ let translate (globals, functions) =
   and graph_t = L.pointer_type (match L.type_by_name llm_graph "struct.graph" with
       None -> raise (Failure "Missing implementation for struct graph")
     | Some t -> t)
+  and builder_t = L.pointer_type (match L.type_by_name llm_graph "struct.string_builder" with
+      None -> raise (Failure "Missing implementation for struct string_builder")
+    | Some t -> t)
   in
 
   (* Return the LLVM type for a MicroC type *)
@@ -129,7 +138,10 @@ let translate (globals, functions) =
   let list_add_tail_t = L.function_type i32_t [| lst_t; void_ptr_t |] in
   let list_add_tail_func = L.declare_function "add_tail" list_add_tail_t the_module in
 
-  (* Testing casting void inside the C code. Test <int>*)
+  (* Ints, floats and bools are stored unboxed in the list slots *)
+  let list_get_int_t = L.function_type i32_t [| lst_t; i32_t |] in
+  let list_get_int_func = L.declare_function "list_get_int" list_get_int_t the_module in
+
 
   let list_set_int_t = L.function_type i32_t [| lst_t; i32_t; i32_t |] in
   let list_set_int_func = L.declare_function "list_set_int" list_set_int_t the_module in
@@ -143,6 +155,22 @@ let translate (globals, functions) =
   let list_add_tail_int_t = L.function_type i32_t [| lst_t; i32_t |] in
   let list_add_tail_int_func = L.declare_function "add_tail_int" list_add_tail_int_t the_module in
 
+  (* List<bool> *)
+  let list_get_bool_t = L.function_type i1_t [| lst_t; i32_t |] in
+  let list_get_bool_func = L.declare_function "list_get_bool" list_get_bool_t the_module in
+
+  let list_set_bool_t = L.function_type i1_t [| lst_t; i32_t; i1_t |] in
+  let list_set_bool_func = L.declare_function "list_set_bool" list_set_bool_t the_module in
+
+  let list_add_head_bool_t = L.function_type i32_t [| lst_t; i1_t |] in
+  let list_add_head_bool_func = L.declare_function "add_head_bool" list_add_head_bool_t the_module in
+
+  let list_rm_head_bool_t = L.function_type i1_t [| lst_t |] in
+  let list_rm_head_bool_func = L.declare_function "remove_head_bool" list_rm_head_bool_t the_module in
+
+  let list_add_tail_bool_t = L.function_type i32_t [| lst_t; i1_t |] in
+  let list_add_tail_bool_func = L.declare_function "add_tail_bool" list_add_tail_bool_t the_module in
+
   (* Convert Maps to Void * for usage for List<map> *)
   let list_set_map_t = L.function_type map_t [| lst_t; i32_t; map_t |] in
   let list_set_map_func = L.declare_function "list_set_map" list_set_map_t the_module in
@@ -169,7 +197,10 @@ let translate (globals, functions) =
   let list_add_tail_str_t = L.function_type i32_t [| lst_t; str_t |] in
   let list_add_tail_str_func = L.declare_function "add_tail_str" list_add_tail_str_t the_module in
 
-  (* Convert float/decimal to Void * for usage for List<float> *)
+  (* List<float> *)
+  let list_get_dec_t = L.function_type float_t [| lst_t; i32_t |] in
+  let list_get_dec_func = L.declare_function "list_get_dec" list_get_dec_t the_module in
+
   let list_set_dec_t = L.function_type float_t [| lst_t; i32_t; float_t |] in
   let list_set_dec_func = L.declare_function "list_set_dec" list_set_dec_t the_module in
 
@@ -187,19 +218,19 @@ let translate (globals, functions) =
   let make_map_func = L.declare_function "make_map" make_map_t the_module in
 
   let map_contains_key_t = L.function_type i32_t [| map_t; str_t |] in
-  let map_contains_key_func = L.declare_function "contains_key" map_contains_key_t the_module in
+  let map_contains_key_func = L.declare_function "contains_key_str" map_contains_key_t the_module in
 
   let map_contains_value_t = L.function_type i32_t [| map_t; str_t |] in
   let map_contains_value_func = L.declare_function "contains_value" map_contains_value_t the_module in
 
   let map_put_t = L.function_type i32_t [| map_t; str_t; str_t |] in
-  let map_put_func = L.declare_function "put" map_put_t the_module in  
+  let map_put_func = L.declare_function "put_str" map_put_t the_module in  
 
   let map_get_t = L.function_type str_t [|map_t; str_t|] in
-  let map_get_func = L.declare_function "map_get" map_get_t the_module in 
+  let map_get_func = L.declare_function "map_get_str" map_get_t the_module in 
 
   let map_remove_node_t = L.function_type i32_t [| map_t; str_t|] in
-  let map_remove_node_func = L.declare_function "remove_node" map_remove_node_t the_module in
+  let map_remove_node_func = L.declare_function "remove_node_str" map_remove_node_t the_module in
 
   let map_is_equal_t = L.function_type i32_t [| map_t; map_t|] in
   let map_is_equal_func = L.declare_function "is_equal" map_is_equal_t the_module in
@@ -217,6 +248,9 @@ let translate (globals, functions) =
   let graph_add_wedge_t = L.function_type graph_t [|graph_t; map_t; str_t; map_t|] in
   let graph_add_wedge_f = L.declare_function "add_wedge" graph_add_wedge_t the_module in
   
+  let graph_add_batch_t = L.function_type void_t [|graph_t; L.pointer_type map_t; L.pointer_type str_t; L.pointer_type map_t; i32_t|] in
+  let graph_add_batch_f = L.declare_function "add_batch" graph_add_batch_t the_module in
+
   let graph_del_edge_t = L.function_type graph_t [|graph_t; map_t; map_t|] in
   let graph_del_edge_f = L.declare_function "delete_edge" graph_del_edge_t the_module in
 
@@ -238,13 +272,85 @@ let translate (globals, functions) =
   let graph_get_nodes_t = L.function_type lst_t [|graph_t; map_t|] in
   let graph_get_nodes_f = L.declare_function "get_edge_neighbors" graph_get_nodes_t the_module in
 
+  let graph_get_in_nodes_t = L.function_type lst_t [|graph_t; map_t|] in
+  let graph_get_in_nodes_f = L.declare_function "get_in_neighbors" graph_get_in_nodes_t the_module in
+
+  let graph_get_label_nodes_t = L.function_type lst_t [|graph_t; map_t; str_t|] in
+  let graph_get_label_nodes_f = L.declare_function "get_neighbors_by_label" graph_get_label_nodes_t the_module in
+
   let graph_get_all_nodes_t = L.function_type lst_t [|graph_t|] in
   let graph_get_all_nodes_f = L.declare_function "get_all_vertices" graph_get_all_nodes_t the_module in
 
+  (* Read a single element or the length of the lists above without building them *)
+  let graph_degree_t = L.function_type i32_t [|graph_t; map_t|] in
+  let graph_degree_f = L.declare_function "vertex_degree" graph_degree_t the_module in
+
+  let graph_total_t = L.function_type i32_t [|graph_t|] in
+  let graph_total_f = L.declare_function "vertex_total" graph_total_t the_module in
+
+  let graph_neighbor_at_t = L.function_type map_t [|graph_t; map_t; i32_t|] in
+  let graph_neighbor_at_f = L.declare_function "get_neighbor_at" graph_neighbor_at_t the_module in
+
+  let graph_edge_at_t = L.function_type str_t [|graph_t; map_t; i32_t|] in
+  let graph_edge_at_f = L.declare_function "get_edge_at" graph_edge_at_t the_module in
+
+  let graph_vertex_at_t = L.function_type map_t [|graph_t; i32_t|] in
+  let graph_vertex_at_f = L.declare_function "get_vertex_at" graph_vertex_at_t the_module in
+
+  let graph_index_attr_t = L.function_type void_t [| graph_t; str_t |] in
+  let graph_index_attr_f = L.declare_function "index_attribute" graph_index_attr_t the_module in
+
+  let graph_find_vertices_t = L.function_type lst_t [| graph_t; str_t; str_t |] in
+  let graph_find_vertices_f = L.declare_function "find_vertices" graph_find_vertices_t the_module in
+
+  let graph_dedupe_t = L.function_type i32_t [| graph_t |] in
+  let graph_dedupe_f = L.declare_function "dedupe_vertices" graph_dedupe_t the_module in
+
+  let graph_traversal_t = L.function_type lst_t [| graph_t; map_t |] in
+  let graph_bfs_f = L.declare_function "bfs_order" graph_traversal_t the_module in
+  let graph_dfs_f = L.declare_function "dfs_order" graph_traversal_t the_module in
+  let graph_bfs_depths_f = L.declare_function "bfs_depths" graph_traversal_t the_module in
+  let graph_bfs_parents_f = L.declare_function "bfs_parents" graph_traversal_t the_module in
+  let traversals = [("bfs", graph_bfs_f); ("dfs", graph_dfs_f);
+                    ("bfs_depths", graph_bfs_depths_f); ("bfs_parents", graph_bfs_parents_f)] in
+
+  let graph_shortest_path_t = L.function_type lst_t [| graph_t; map_t; map_t |] in
+  let graph_shortest_path_f = L.declare_function "shortest_path" graph_shortest_path_t the_module in
+  let graph_shortest_distance_t = L.function_type float_t [| graph_t; map_t; map_t |] in
+  let graph_shortest_distance_f = L.declare_function "shortest_distance" graph_shortest_distance_t the_module in
+
+  let graph_pagerank_t = L.function_type lst_t [| graph_t; float_t; i32_t; float_t |] in
+  let graph_pagerank_f = L.declare_function "pagerank_list" graph_pagerank_t the_module in
+
+  let graph_components_t = L.function_type lst_t [| graph_t |] in
+  let graph_weak_components_f = L.declare_function "weak_components_list" graph_components_t the_module in
+  let graph_strong_components_f = L.declare_function "strong_components_list" graph_components_t the_module in
+
+  let graph_freeze_t = L.function_type void_ptr_t [| graph_t |] in
+  let graph_freeze_f = L.declare_function "freeze_graph" graph_freeze_t the_module in
+
+  let graph_columnize_t = L.function_type void_ptr_t [| graph_t |] in
+  let graph_columnize_f = L.declare_function "columnize_graph" graph_columnize_t the_module in
+
+  let graph_set_threads_t = L.function_type void_t [| i32_t |] in
+  let graph_set_threads_f = L.declare_function "graph_set_threads" graph_set_threads_t the_module in
+
   (* Miscellanous functions, string ops, list concat, etc.*)
   let concat_string_t = L.function_type str_t [| str_t; str_t |] in
   let concat_string_func = L.declare_function "concat_string" concat_string_t the_module in
 
+  let make_builder_t = L.function_type builder_t [||] in
+  let make_builder_func = L.declare_function "make_builder" make_builder_t the_module in
+
+  let builder_set_t = L.function_type void_t [| builder_t; str_t |] in
+  let builder_set_func = L.declare_function "builder_set" builder_set_t the_module in
+
+  let builder_append_t = L.function_type void_t [| builder_t; str_t |] in
+  let builder_append_func = L.declare_function "builder_append" builder_append_t the_module in
+
+  let builder_string_t = L.function_type str_t [| builder_t |] in
+  let builder_string_func = L.declare_function "builder_string" builder_string_t the_module in
+
   let length_t = L.function_type i32_t [| str_t |] in
   let length_func = L.declare_function "length" length_t the_module in
 
@@ -257,6 +363,31 @@ let translate (globals, functions) =
   let concat_list_t = L.function_type lst_t [| lst_t; lst_t |] in
   let concat_list_func = L.declare_function "concat" concat_list_t the_module in
 
+  let intern_string_t = L.function_type str_t [| str_t |] in
+  let intern_string_func = L.declare_function "intern_string" intern_string_t the_module in
+
+  let intern_strings_t = L.function_type void_t [| L.pointer_type str_t; i32_t |] in
+  let intern_strings_func = L.declare_function "intern_strings" intern_strings_t the_module in
+
+  (* A string literal is a constant laid out as the runtime's string
+     header (length, hash, interned) followed by the characters; its
+     value points at the characters. Each distinct literal is emitted
+     once and is the interned copy of its value, so literals[s] is
+     handed to intern_strings when main starts *)
+  let literals = Hashtbl.create 64 in
+  let string_literal s =
+    try Hashtbl.find literals s with Not_found ->
+    let init = L.const_struct context [| L.const_int i32_t (String.length s);
+                                         L.const_int i32_t (string_hash s);
+                                         L.const_int i32_t 1;
+                                         L.const_stringz context s |] in
+    let g = L.define_global "str" init the_module in
+    L.set_global_constant true g;
+    L.set_linkage L.Linkage.Private g;
+    let p = L.const_in_bounds_gep g [| L.const_int i32_t 0; L.const_int i32_t 3; L.const_int i32_t 0 |] in
+    Hashtbl.add literals s p; p
+  in
+
   (* Define each function (arguments and return type) so we can 
      call it even before we've created its body *)
   let function_decls : (L.llvalue * sfunc_decl) StringMap.t =
@@ -307,6 +438,21 @@ let translate (globals, functions) =
                    with Not_found -> StringMap.find n global_vars
     in
 
+    (* Local strings grown with s = s + x or s += x keep their value in a
+       string builder, so an append does not copy what came before. The
+       char * is only made when the variable is read. *)
+    let string_builders =
+      let add_builder m n =
+        if not (StringMap.mem n local_vars) then m else
+        let sb = L.build_call make_builder_func [||] (n ^ "_sb") builder in
+        if List.exists (fun (_, f) -> f = n) fdecl.sformals then
+          ignore(L.build_call builder_set_func
+                   [| sb; L.build_load (lookup n) n builder |] "" builder);
+        StringMap.add n sb m
+      in
+      List.fold_left add_builder StringMap.empty fdecl.sappends
+    in
+
     (* Construct code for an expression; return its value *)
     let rec expr builder ((styp, e) : sexpr) = 
 	
@@ -314,34 +460,69 @@ let translate (globals, functions) =
         SLiteral i  -> L.const_int i32_t i
       | SBoolLit b  -> L.const_int i1_t (if b then 1 else 0)
       | SFliteral l -> L.const_float_of_string float_t l
-      | SStrLit l    -> L.build_global_stringptr l "str" builder
+      | SStrLit l    -> string_literal l
       | SNoexpr     -> L.const_int i32_t 0
+      | SId s when StringMap.mem s string_builders ->
+          L.build_call builder_string_func [| StringMap.find s string_builders |] s builder
       | SId s       -> L.build_load (lookup s) s builder
       | SCharLit l -> L.const_int i8_t (C.code l)
       | SListLit l -> let rec list_fill lst = (function
 		[] -> lst
 		| sx :: rest ->
 		let (t, _) = sx in 
+		(match t with
+		  A.Int -> ignore(L.build_call list_add_tail_int_func [| lst; expr builder sx |] "add_tail_int" builder)
+		| A.Float -> ignore(L.build_call list_add_tail_dec_func [| lst; expr builder sx |] "add_tail_dec" builder)
+		| A.Bool -> ignore(L.build_call list_add_tail_bool_func [| lst; expr builder sx |] "add_tail_bool" builder)
+		| _ ->
 		let data = (match t with
 			  A.Map |A.Graph |A.List _ | A.String -> expr builder sx 
 			| _ -> let data = L.build_malloc (ltype_of_typ t) "data" builder in
 				let llvm =  expr builder sx 
 				in ignore(L.build_store llvm data builder); data)
 		in let data = L.build_bitcast data void_ptr_t "data" builder in
-			ignore(L.build_call list_add_tail_func [| lst; data |] "list_add_tail" builder); list_fill lst rest) in
+			ignore(L.build_call list_add_tail_func [| lst; data |] "list_add_tail" builder)); list_fill lst rest) in
 		let m = L.build_call make_list_func [||] "make_list" builder in
 		list_fill m l
+	  (* A graph query used once by .len() or .at() is answered in place,
+	     without materializing its list *)
+	  | SListSize((_, SGraphNodes(g, n))) | SListSize((_, SGraphEdges(g, n))) ->
+		let graph = expr builder g
+		and node = expr builder n in
+		L.build_call graph_degree_f [|graph; node|] "vertex_degree" builder
+	  | SListSize((_, SGraphAll(g))) | SListSize((_, SGraphAllNodes(g))) ->
+		let graph = expr builder g in
+		L.build_call graph_total_f [|graph|] "vertex_total" builder
+	  | SListGet((_, SGraphNodes(g, n)), idx) ->
+		let graph = expr builder g
+		and node = expr builder n
+		and index = expr builder idx in
+		L.build_call graph_neighbor_at_f [|graph; node; index|] "get_neighbor_at" builder
+	  | SListGet((_, SGraphEdges(g, n)), idx) ->
+		let graph = expr builder g
+		and node = expr builder n
+		and index = expr builder idx in
+		L.build_call graph_edge_at_f [|graph; node; index|] "get_edge_at" builder
+	  | SListGet((_, SGraphAll(g)), idx) | SListGet((_, SGraphAllNodes(g)), idx) ->
+		let graph = expr builder g
+		and index = expr builder idx in
+		L.build_call graph_vertex_at_f [|graph; index|] "get_vertex_at" builder
 	  | SListSize(l) -> let l' = expr builder l in 
 			L.build_call list_size_func [|l'|] "size" builder;   
       | SListGet(l, idx) ->
 		let ltype = ltype_of_typ styp in
 		let lst = expr builder l in
 		let index = expr builder idx in
+		(match styp with
+			A.Int -> L.build_call list_get_int_func [| lst; index |] "list_get_int" builder
+			| A.Float -> L.build_call list_get_dec_func [| lst; index |] "list_get_dec" builder
+			| A.Bool -> L.build_call list_get_bool_func [| lst; index |] "list_get_bool" builder
+			| _ ->
 		let data = L.build_call list_get_func [| lst; index |] "index" builder in
 		(match styp with 
 			A.List _ | A.Graph | A.String | A.Map -> L.build_bitcast data ltype "data" builder
 			| _ -> let data = L.build_bitcast data (L.pointer_type ltype) "data" builder in
-				L.build_load data "data" builder)
+				L.build_load data "data" builder))
       | SListSet(l, idx, e) -> 
 			let r = (match check_list_type(l) with
 			 A.Int -> let l' = expr builder l and idx' = expr builder idx and e' = expr builder e in
@@ -352,6 +533,8 @@ let translate (globals, functions) =
 				L.build_call list_set_str_func [|l'; idx'; e'|] "list_set_str" builder;
 			| A.Float -> let l' = expr builder l and idx' = expr builder idx and e' = expr builder e in
 				L.build_call list_set_dec_func [|l'; idx'; e'|] "list_set_dec" builder;
+			| A.Bool -> let l' = expr builder l and idx' = expr builder idx and e' = expr builder e in
+				L.build_call list_set_bool_func [|l'; idx'; e'|] "list_set_bool" builder;
 			| _ -> raise(Failure("Not Valid List Lit Type!"))) in
 			r  
       | SList_Add_Head(l, e) -> 			
@@ -364,6 +547,8 @@ let translate (globals, functions) =
 				 L.build_call list_add_head_str_func [|l'; e'|] "add_head_str" builder;
 			| A.Float -> let l' = expr builder l and e' = expr builder e in
 				 L.build_call list_add_head_dec_func [|l'; e'|] "add_head_dec" builder;
+			| A.Bool -> let l' = expr builder l and e' = expr builder e in
+				 L.build_call list_add_head_bool_func [|l'; e'|] "add_head_bool" builder;
 			| _ -> raise(Failure("Not Valid List Lit Type!"))) in
 			r
       | SList_Rm_Head(l) -> 
@@ -376,6 +561,8 @@ let translate (globals, functions) =
 				L.build_call list_rm_head_str_func [|l'|] "remove_head_str" builder;
 			| A.Float -> let l' = expr builder l in 
 				L.build_call list_rm_head_dec_func [|l'|] "remove_head_dec" builder;
+			| A.Bool -> let l' = expr builder l in
+				L.build_call list_rm_head_bool_func [|l'|] "remove_head_bool" builder;
 			| _ -> raise(Failure("Not Valid List Lit Type!"))) in
 			r
       | SList_Add_Tail(l, e) -> let r = (match get_type(e) with
@@ -387,6 +574,8 @@ let translate (globals, functions) =
 				L.build_call list_add_tail_str_func [|l'; e'|] "add_tail_str" builder;
 			| A.Float -> let l' = expr builder l and e' = expr builder e in
 				L.build_call list_add_tail_dec_func [|l'; e'|] "add_tail_dec" builder;
+			| A.Bool -> let l' = expr builder l and e' = expr builder e in
+				L.build_call list_add_tail_bool_func [|l'; e'|] "add_tail_bool" builder;
 			| _ -> raise(Failure("Not Valid List Lit Type!"))) in
 			r 	
       | SMapLit l ->
@@ -398,50 +587,39 @@ let translate (globals, functions) =
           m
       | SGraphLit l ->
           let g = L.build_call graph_constructor_f [||] "new_graph" builder in
-          List.iter (fun (_, e) -> ignore(
-              match e with    
-              | SGraphAddVertex(n) -> 
-                  let n' = expr builder n in
-                  L.build_call graph_add_vertex_f [|g; n'|] "add_vertex" builder
-              | SGraphAddEdge (n1, n2) -> 
-                  let n1' = expr builder n1 
-                  and n2' = expr builder n2 in
-                  L.build_call graph_add_edge_f [|g; n1'; n2'|] "add_edge" builder
-              | SGraphAddWedge (n1, w, n2) ->
-                  let n1' = expr builder n1 
-                  and w' = expr builder w
-                  and n2' = expr builder n2 in
-                  L.build_call graph_add_wedge_f [|g; n1'; w'; n2'|] "add_wedge" builder
-              | _ -> raise(Failure("Unsupported operation.")))) l;
+          (match l with
+            [] -> ()
+          | [e] -> ignore(graph_change builder g e)
+          | _ -> graph_batch builder g l);
           g
 
       | SGraphMod (g, l) -> 
           let g' = L.build_load (lookup g) g builder in 
-          List.iter (fun (_,e) -> ignore(
-              match e with    
-                SGraphAddVertex(n) -> 
-                  let n' = expr builder n in
-                  L.build_call graph_add_vertex_f [|g'; n'|] "graph_add_vertex" builder
-              | SGraphAddEdge (n1, n2) -> 
-                  let n1' = expr builder n1 
-                  and n2' = expr builder n2 in
-                  L.build_call graph_add_edge_f [|g'; n1'; n2'|] "graph_add_edge" builder
-              | SGraphAddWedge (n1, w, n2) ->
-                  let n1' = expr builder n1 
-                  and w' = expr builder w
-                  and n2' = expr builder n2 in
-                  L.build_call graph_add_wedge_f [|g'; n1'; w'; n2'|] "graph_add_wedge" builder
-              | SGraphDelVertex (n) ->
-                  let n' = expr builder n in
-                  L.build_call graph_del_vertex_f [|g'; n'|] "graph_del_vertex" builder
-              | SGraphDelEdge (n1, n2) ->
-                  let n1' = expr builder n1
-                  and n2' = expr builder n2 in
-                  L.build_call graph_del_edge_f [|g'; n1'; n2'|] "graph_del_edge" builder
-              | _ -> raise(Failure("Unsupported operation.")))) l;
+          (* runs of consecutive additions go to the runtime as one batch *)
+          let flush = function
+              [] -> ()
+            | [e] -> ignore(graph_change builder g' e)
+            | run -> graph_batch builder g' (List.rev run) in
+          let run = List.fold_left (fun run e ->
+              match e with
+                (_, SGraphAddVertex _) | (_, SGraphAddEdge _) | (_, SGraphAddWedge _) -> e :: run
+              | _ -> flush run; ignore(graph_change builder g' e); []) [] l in
+          flush run;
           g'
       | SAssign (s, e) -> let e' = expr builder e in
-          ignore(L.build_store e' (lookup s) builder); e'
+          ignore(L.build_store e' (lookup s) builder);
+          if StringMap.mem s string_builders then
+            ignore(L.build_call builder_set_func
+                     [| StringMap.find s string_builders; e' |] "" builder);
+          e'
+      | SStrAppend (s, e) when StringMap.mem s string_builders ->
+          let sb = StringMap.find s string_builders in
+          ignore(L.build_call builder_append_func [| sb; expr builder e |] "" builder);
+          L.build_call builder_string_func [| sb |] s builder
+      | SStrAppend (s, e) ->
+          expr builder (styp, SAssign (s, (styp, SBinop ((styp, SId s), A.Add, e))))
+      | SOpAssign (s, op, e) ->
+          expr builder (styp, SAssign (s, (styp, SBinop ((styp, SId s), op, e))))
 
       | SBinop ((A.List(_), _) as e1, op, e2) ->
 		let e1' = expr builder e1 
@@ -537,6 +715,47 @@ let translate (globals, functions) =
           L.build_call printm_func [| (expr builder e) |] "printm" builder
       | SCall ("printg", [e]) ->
           L.build_call printg_func [| (expr builder e) |] "printg" builder
+      | SCall ("freeze", [e]) ->
+          L.build_call graph_freeze_f [| (expr builder e) |] "freeze_graph" builder
+      | SCall ("columnize", [e]) ->
+          L.build_call graph_columnize_f [| (expr builder e) |] "columnize_graph" builder
+      | SCall ("set_threads", [e]) ->
+          L.build_call graph_set_threads_f [| (expr builder e) |] "" builder
+      | SCall ("index_attribute", [g; k]) ->
+          let g' = expr builder g
+          and k' = expr builder k in
+          L.build_call graph_index_attr_f [| g'; k' |] "" builder
+      | SCall ("find_vertices", [g; k; v]) ->
+          let g' = expr builder g
+          and k' = expr builder k
+          and v' = expr builder v in
+          L.build_call graph_find_vertices_f [| g'; k'; v' |] "find_vertices" builder
+      | SCall ("dedupe_vertices", [g]) ->
+          L.build_call graph_dedupe_f [| (expr builder g) |] "dedupe_vertices" builder
+      | SCall (f, [g; src]) when List.mem_assoc f traversals ->
+          let g' = expr builder g
+          and src' = expr builder src in
+          L.build_call (List.assoc f traversals) [| g'; src' |] f builder
+      | SCall ("shortest_path", [g; a; b]) ->
+          let g' = expr builder g
+          and a' = expr builder a
+          and b' = expr builder b in
+          L.build_call graph_shortest_path_f [| g'; a'; b' |] "shortest_path" builder
+      | SCall ("shortest_distance", [g; a; b]) ->
+          let g' = expr builder g
+          and a' = expr builder a
+          and b' = expr builder b in
+          L.build_call graph_shortest_distance_f [| g'; a'; b' |] "shortest_distance" builder
+      | SCall ("pagerank", [g; d; n; t]) ->
+          let g' = expr builder g
+          and d' = expr builder d
+          and n' = expr builder n
+          and t' = expr builder t in
+          L.build_call graph_pagerank_f [| g'; d'; n'; t' |] "pagerank" builder
+      | SCall ("weak_components", [g]) ->
+          L.build_call graph_weak_components_f [| (expr builder g) |] "weak_components" builder
+      | SCall ("strong_components", [g]) ->
+          L.build_call graph_strong_components_f [| (expr builder g) |] "strong_components" builder
       | SCall (f, args) ->
          let (fdef, fdecl) = StringMap.find f function_decls in
          let llargs = List.rev (List.map (expr builder) (List.rev args)) in
@@ -552,6 +771,15 @@ let translate (globals, functions) =
         let graph = expr builder g 
         and node = expr builder n in 
         L.build_call graph_get_nodes_f [|graph; node|] "get_edge_neighbors" builder
+      | SGraphInNodes (g, n) ->
+        let graph = expr builder g
+        and node = expr builder n in
+        L.build_call graph_get_in_nodes_f [|graph; node|] "get_in_neighbors" builder
+      | SGraphLabelNodes (g, n, l) ->
+        let graph = expr builder g
+        and node = expr builder n
+        and label = expr builder l in
+        L.build_call graph_get_label_nodes_f [|graph; node; label|] "get_neighbors_by_label" builder
       | SGraphAllNodes (g) ->
         let graph = expr builder g in
         L.build_call graph_get_all_nodes_f [|graph|] "get_all_nodes" builder
@@ -587,6 +815,65 @@ let translate (globals, functions) =
                 L.build_call map_is_equal_func [|map1; map2|] "is_equal" builder;
     
 	  | _ -> raise(Failure("Unsupported operation."))
+
+    (* One element of a graph literal or modification, as a single runtime call *)
+    and graph_change builder g (_, e) =
+      match e with
+        SGraphAddVertex(n) ->
+          let n' = expr builder n in
+          L.build_call graph_add_vertex_f [|g; n'|] "graph_add_vertex" builder
+      | SGraphAddEdge (n1, n2) ->
+          let n1' = expr builder n1
+          and n2' = expr builder n2 in
+          L.build_call graph_add_edge_f [|g; n1'; n2'|] "graph_add_edge" builder
+      | SGraphAddWedge (n1, w, n2) ->
+          let n1' = expr builder n1
+          and w' = interned builder w
+          and n2' = expr builder n2 in
+          L.build_call graph_add_wedge_f [|g; n1'; w'; n2'|] "graph_add_wedge" builder
+      | SGraphDelVertex (n) ->
+          let n' = expr builder n in
+          L.build_call graph_del_vertex_f [|g; n'|] "graph_del_vertex" builder
+      | SGraphDelEdge (n1, n2) ->
+          let n1' = expr builder n1
+          and n2' = expr builder n2 in
+          L.build_call graph_del_edge_f [|g; n1'; n2'|] "graph_del_edge" builder
+      | _ -> raise(Failure("Unsupported operation."))
+
+    (* Additions to a graph, as one add_batch call over arrays of
+       (from, data, to); to is null for a lone vertex. The arrays are
+       allocated in the entry block so loops do not grow the stack. *)
+    and graph_batch builder g l =
+      let count = L.const_int i32_t (List.length l) in
+      let entry = L.entry_block (L.block_parent (L.insertion_block builder)) in
+      let entry_builder = L.builder_at context (L.instr_begin entry) in
+      let froms = L.build_array_alloca map_t count "batch_from" entry_builder
+      and datas = L.build_array_alloca str_t count "batch_data" entry_builder
+      and tos = L.build_array_alloca map_t count "batch_to" entry_builder in
+      let store arr i v =
+        let slot = L.build_gep arr [| L.const_int i32_t i |] "batch_slot" builder in
+        ignore(L.build_store v slot builder) in
+      List.iteri (fun i (_, e) ->
+          let (n1, w, n2) = (match e with
+              SGraphAddVertex(n) -> (n, None, None)
+            | SGraphAddEdge(n1, n2) -> (n1, None, Some n2)
+            | SGraphAddWedge(n1, w, n2) -> (n1, Some w, Some n2)
+            | _ -> raise(Failure("Unsupported operation."))) in
+          let n1' = expr builder n1 in
+          let w' = (match w with
+              Some w -> interned builder w
+            | None -> string_literal "") in
+          let n2' = (match n2 with
+              Some n2 -> expr builder n2
+            | None -> L.const_null map_t) in
+          store froms i n1'; store datas i w'; store tos i n2') l;
+      ignore(L.build_call graph_add_batch_f [|g; froms; datas; tos; count|] "" builder)
+
+    (* Edge data is interned, so equal labels share one string; literals
+       already are *)
+    and interned builder ((_, e) as w) = match e with
+        SStrLit l -> string_literal l
+      | _ -> L.build_call intern_string_func [| expr builder w |] "interned" builder
 	  in 
 
     (* LLVM insists each basic block end with exactly one "terminator"
@@ -604,6 +891,11 @@ let translate (globals, functions) =
 
     let rec stmt builder = function
         SBlock sl -> List.fold_left stmt builder sl
+      (* An append whose value is unused need not make the string *)
+      | SExpr (_, SStrAppend (s, e)) when StringMap.mem s string_builders ->
+          ignore(L.build_call builder_append_func
+                   [| StringMap.find s string_builders; expr builder e |] "" builder);
+          builder
       | SExpr e -> ignore(expr builder e); builder
       | SReturn e -> ignore(match fdecl.styp with
                               (* Special "return nothing" instr *)
@@ -653,4 +945,16 @@ let translate (globals, functions) =
   in
       
   List.iter build_function_body functions;
+
+  (* Intern every string literal before main runs *)
+  (match StringMap.find_opt "main" function_decls with
+     Some (main, _) when Hashtbl.length literals > 0 ->
+       let strs = Hashtbl.fold (fun _ p l -> p :: l) literals [] in
+       let table = L.define_global "literals" (L.const_array str_t (Array.of_list strs)) the_module in
+       L.set_linkage L.Linkage.Private table;
+       let builder = L.builder_at context (L.instr_begin (L.entry_block main)) in
+       let first = L.build_in_bounds_gep table [| L.const_int i32_t 0; L.const_int i32_t 0 |] "literals" builder in
+       ignore(L.build_call intern_strings_func
+                [| first; L.const_int i32_t (List.length strs) |] "" builder)
+   | _ -> ());
   the_module
@@ -6,11 +6,399 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+/*
+ * SLAB METHODS
+ */
+
+#define SLAB_MIN_CHUNK_OBJECTS 32
+#define SLAB_MAX_CHUNK_OBJECTS 4096
+
+/*
+ * Chunks are chained through their header; the union keeps the
+ * objects that follow it suitably aligned.
+ */
+struct slab_chunk {
+	union {
+		struct slab_chunk *next;
+		long double align;
+	} header;
+};
+
+/*
+ * Initializes a slab for objects of the given size.
+ */
+void slab_init(struct slab *s, int object_size) {
+
+	/* freed objects hold the free list link, keep them pointer aligned */
+	int align = sizeof(void *);
+	if (object_size < align)
+		object_size = align;
+	s->object_size = (object_size + align - 1) / align * align;
+	s->chunk_objects = SLAB_MIN_CHUNK_OBJECTS;
+	s->chunks = NULL;
+	s->free_objects = NULL;
+	s->cursor = NULL;
+	s->remaining = 0;
+}
+
+/*
+ * Returns an uninitialized object, or NULL if out of memory.
+ * Chunks double in size up to SLAB_MAX_CHUNK_OBJECTS objects.
+ */
+void * slab_alloc(struct slab *s) {
+
+	if (s->free_objects != NULL) {
+		void *object = s->free_objects;
+		s->free_objects = *(void **) object;
+		return object;
+	}
+
+	if (s->remaining == 0) {
+		struct slab_chunk *chunk;
+		chunk = malloc(sizeof(struct slab_chunk) + (size_t) s->chunk_objects * s->object_size);
+		if (chunk == NULL)
+			return NULL;
+		chunk->header.next = s->chunks;
+		s->chunks = chunk;
+		s->cursor = (char *) (chunk + 1);
+		s->remaining = s->chunk_objects;
+		if (s->chunk_objects < SLAB_MAX_CHUNK_OBJECTS)
+			s->chunk_objects *= 2;
+	}
+
+	void *object = s->cursor;
+	s->cursor += s->object_size;
+	s->remaining -= 1;
+	return object;
+}
+
+/*
+ * Gives an object back to the slab it came from.
+ */
+void slab_free(struct slab *s, void *object) {
+
+	if (object == NULL)
+		return;
+	*(void **) object = s->free_objects;
+	s->free_objects = object;
+}
+
+/*
+ * Frees every chunk of the slab, and with them all of its objects.
+ */
+void slab_release(struct slab *s) {
+
+	struct slab_chunk *chunk = s->chunks;
+	while (chunk != NULL) {
+		struct slab_chunk *next = chunk->header.next;
+		free(chunk);
+		chunk = next;
+	}
+	slab_init(s, s->object_size);
+}
+
+/*
+ * STRING METHODS
+ */
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+/*
+ * FNV-1a hash of a NUL-terminated string.
+ */
+static unsigned int _hash_string(const char *s) {
+
+	unsigned int h = FNV_OFFSET_BASIS;
+	while (*s) {
+		h ^= (unsigned char) *s++;
+		h *= FNV_PRIME;
+	}
+	return h;
+}
+
+/*
+ * Carries on an FNV-1a hash h over n more characters, so the hash of
+ * a + b follows from the hash of a without reading a again.
+ */
+static unsigned int _hash_extend(unsigned int h, const char *s, int n) {
+
+	int i;
+	for (i = 0; i < n; ++i) {
+		h ^= (unsigned char) s[i];
+		h *= FNV_PRIME;
+	}
+	return h;
+}
+
+/*
+ * A header and its characters in one object, for the runtime's own
+ * constant strings.
+ */
+struct static_string {
+	struct string_header header;
+	char chars[2];
+};
+
+/* Data of edges added without any */
+static struct static_string _empty_string = { { 0, FNV_OFFSET_BASIS, 0 }, "" };
+#define EMPTY_STRING (_empty_string.chars)
+
+/* The one-character strings handed out by get_char */
+static struct static_string _char_strings[256];
+static pthread_once_t _char_strings_once = PTHREAD_ONCE_INIT;
+
+static void _init_char_strings(void) {
+
+	int c;
+	for (c = 0; c < 256; ++c) {
+		_char_strings[c].header.length = c ? 1 : 0;
+		_char_strings[c].header.hash = c ? (FNV_OFFSET_BASIS ^ c) * FNV_PRIME : FNV_OFFSET_BASIS;
+		_char_strings[c].header.interned = 0;
+		_char_strings[c].chars[0] = (char) c;
+		_char_strings[c].chars[1] = '\0';
+	}
+}
+
+/*
+ * Makes a string with a header from the first length characters
+ * of chars.
+ */
+char * make_string(const char *chars, int length) {
+
+	struct string_header *h = malloc(sizeof(struct string_header) + length + 1);
+	if (h == NULL)
+		return NULL;
+
+	char *s = (char *) (h + 1);
+	memcpy(s, chars, length);
+	s[length] = '\0';
+	h->length = length;
+	h->hash = _hash_extend(FNV_OFFSET_BASIS, s, length);
+	h->interned = 0;
+	return s;
+}
+
+/*
+ * Returns the hash kept in the header of s.
+ */
+unsigned int string_hash(char *s) {
+
+	return STRING_HEADER(s)->hash;
+}
+
+#define INTERN_MIN_CAPACITY 64
+
+/*
+ * The intern table: one string per distinct value, in a linear-probing
+ * table of capacity slots (a power of two, NULL when empty).
+ * Interned strings live for the rest of the program.
+ */
+static char **intern_slots = NULL;
+static int intern_size = 0;
+static int intern_capacity = 0;
+
+static void _intern_insert(char *s) {
+
+	int mask = intern_capacity - 1;
+	int i = STRING_HEADER(s)->hash & mask;
+	while (intern_slots[i] != NULL)
+		i = (i + 1) & mask;
+	intern_slots[i] = s;
+}
+
+/*
+ * Makes room for one more string, keeping the table at most half full.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _intern_reserve(void) {
+
+	if (2 * (intern_size + 1) <= intern_capacity)
+		return 1;
+
+	int capacity = intern_capacity ? 2 * intern_capacity : INTERN_MIN_CAPACITY;
+	char **slots = calloc(capacity, sizeof(char *));
+	if (slots == NULL)
+		return 0;
+
+	char **old = intern_slots;
+	int old_capacity = intern_capacity, i;
+	intern_slots = slots;
+	intern_capacity = capacity;
+	for (i = 0; i < old_capacity; ++i) {
+		if (old[i] != NULL)
+			_intern_insert(old[i]);
+	}
+	free(old);
+	return 1;
+}
+
+/*
+ * Returns the interned string equal to s, making s the interned one
+ * if there is none yet. Two interned strings are equal exactly when
+ * they are the same pointer.
+ */
+char * intern_string(char *s) {
+
+	struct string_header *h = STRING_HEADER(s);
+	if (h->interned)
+		return s;
+
+	if (intern_capacity > 0) {
+		int mask = intern_capacity - 1;
+		int i = h->hash & mask;
+		while (intern_slots[i] != NULL) {
+			struct string_header *o = STRING_HEADER(intern_slots[i]);
+			if (o->hash == h->hash && o->length == h->length &&
+					memcmp(intern_slots[i], s, h->length) == 0)
+				return intern_slots[i];
+			i = (i + 1) & mask;
+		}
+	}
+
+	if (!_intern_reserve())
+		return s;
+	_intern_insert(s);
+	intern_size += 1;
+	h->interned = 1;
+	return s;
+}
+
+/*
+ * Adds n distinct strings that are already marked as interned, such as
+ * the string literals of a program, which are added before it starts.
+ */
+void intern_strings(char **strings, int n) {
+
+	int i;
+	for (i = 0; i < n; ++i) {
+		if (!_intern_reserve())
+			return;
+		_intern_insert(strings[i]);
+		intern_size += 1;
+	}
+}
 
 /*
  * MAP METHODS
  */
 
+#define MAP_SLOT_EMPTY -1
+#define MAP_SLOT_REMOVED -2
+#define MAP_MIN_CAPACITY 8
+
+/*
+ * Largest number of nodes a table of the given capacity may hold
+ * before it has to be rebuilt (load factor 3/4).
+ */
+static int _map_limit(int capacity) {
+
+	return capacity - capacity / 4;
+}
+
+/*
+ * Tables of the smallest capacity, shared by all maps.
+ */
+static struct slab map_table_slab;
+static int map_table_slab_ready = 0;
+
+/*
+ * Bytes needed for the node array followed by the slot array.
+ */
+static size_t _map_table_size(int capacity) {
+
+	return sizeof(struct map_node) * _map_limit(capacity)
+		+ sizeof(struct map_slot) * capacity;
+}
+
+/*
+ * Allocates the node and slot arrays of a table in one block.
+ * Returns the node array, or NULL if out of memory.
+ */
+static struct map_node * _map_table_alloc(int capacity) {
+
+	if (capacity != MAP_MIN_CAPACITY)
+		return malloc(_map_table_size(capacity));
+
+	if (!map_table_slab_ready) {
+		slab_init(&map_table_slab, _map_table_size(MAP_MIN_CAPACITY));
+		map_table_slab_ready = 1;
+	}
+	return slab_alloc(&map_table_slab);
+}
+
+static void _map_table_free(struct map_node *nodes, int capacity) {
+
+	if (capacity == MAP_MIN_CAPACITY)
+		slab_free(&map_table_slab, nodes);
+	else
+		free(nodes);
+}
+
+/*
+ * Returns the slot holding key, or -1 if the key is not in the map.
+ */
+static int _map_find(struct map *m, const char *key, unsigned int hash) {
+
+	if (m->capacity == 0)
+		return -1;
+
+	int mask = m->capacity - 1;
+	int i = hash & mask;
+	while (m->slots[i].index != MAP_SLOT_EMPTY) {
+		struct map_slot *slot = &m->slots[i];
+		if (slot->index >= 0 && slot->hash == hash) {
+			char *k = m->nodes[slot->index].key;
+			if (k == key || strcmp(k, key) == 0)
+				return i;
+		}
+		i = (i + 1) & mask;
+	}
+	return -1;
+}
+
+/*
+ * Rebuilds the slot table with the given capacity, dropping removed
+ * nodes from the node array while keeping insertion order.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _map_rebuild(struct map *m, int capacity) {
+
+	struct map_node *nodes = _map_table_alloc(capacity);
+	if (nodes == NULL)
+		return 0;
+	struct map_slot *slots = (struct map_slot *) (nodes + _map_limit(capacity));
+
+	int i;
+	for (i = 0; i < capacity; ++i)
+		slots[i].index = MAP_SLOT_EMPTY;
+
+	int mask = capacity - 1;
+	int n = 0;
+	for (i = 0; i < m->used; ++i) {
+		if (m->nodes[i].key == NULL)
+			continue;
+		nodes[n] = m->nodes[i];
+		int j = nodes[n].hash & mask;
+		while (slots[j].index != MAP_SLOT_EMPTY)
+			j = (j + 1) & mask;
+		slots[j].hash = nodes[n].hash;
+		slots[j].index = n;
+		++n;
+	}
+
+	if (m->capacity > 0)
+		_map_table_free(m->nodes, m->capacity);
+	m->slots = slots;
+	m->nodes = nodes;
+	m->capacity = capacity;
+	m->used = n;
+	return 1;
+}
+
 /*
  * Initializes an empty map.
  */
@@ -21,56 +409,105 @@ struct map * make_map() {
 	if (m == NULL)
 		return NULL;
 
-	m->node_head = NULL;
+	m->nodes = NULL;
+	m->slots = NULL;
 	m->size = 0;
+	m->used = 0;
+	m->capacity = 0;
+	m->fingerprint = 0;
 	return m;
 }
 
 /*
- * Puts a key-value pair into a map.
+ * Hash of one key-value pair, summed into the map's fingerprint.
+ * Key and value are mixed unevenly so that swapping them matters.
+ */
+static unsigned int _entry_hash(unsigned int hash, unsigned int value_hash) {
+
+	unsigned int x = hash * 0x9e3779b1u + value_hash;
+	x ^= x >> 16;
+	x *= 0x85ebca6bu;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35u;
+	x ^= x >> 16;
+	return x;
+}
+
+/*
+ * Adds key under the given hash unless it is already there.
  * Returns a 1 if successful and 0 otherwise.
  */
-int put(struct map *m, char *key, char *value) {
+static int _map_put(struct map *m, char *key, char *value, unsigned int hash,
+		unsigned int value_hash) {
 
 	/* no duplicate keys allowed */
-	if (contains_key(m, key))
+	if (_map_find(m, key, hash) >= 0)
 		return 0;
 
-	struct map_node *node;
-	node = malloc(sizeof(struct map_node));
-	if (node == NULL)
-		return 0;
+	/* grow when live nodes fill the table, otherwise just compact */
+	if (m->used == _map_limit(m->capacity)) {
+		int capacity = m->capacity ? m->capacity : MAP_MIN_CAPACITY;
+		if (m->size + 1 > _map_limit(capacity) / 2)
+			capacity *= 2;
+		if (!_map_rebuild(m, capacity))
+			return 0;
+	}
 
-	node->key = key;
-	node->value = value;
+	int index = m->used++;
+	m->nodes[index].key = key;
+	m->nodes[index].value = value;
+	m->nodes[index].hash = hash;
+	m->nodes[index].value_hash = value_hash;
+	m->fingerprint += _entry_hash(hash, value_hash);
 
-	if (m->node_head == NULL) {
-		node->next = NULL;
-		m->node_head = node;
-	} else {
-		node->next = m->node_head;
-		m->node_head = node;
-	}
+	int mask = m->capacity - 1;
+	int i = hash & mask;
+	while (m->slots[i].index >= 0)
+		i = (i + 1) & mask;
+	m->slots[i].hash = hash;
+	m->slots[i].index = index;
 
 	m->size += 1;
 	return 1;
 }
 
+/*
+ * Puts a key-value pair into a map.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+int put(struct map *m, char *key, char *value) {
+
+	return _map_put(m, key, value, _hash_string(key),
+			value ? _hash_string(value) : 0);
+}
+
+/*
+ * Like put, but key is a string with a header, whose hash is reused.
+ */
+int put_str(struct map *m, char *key, char *value) {
+
+	key = intern_string(key);
+	return _map_put(m, key, value, string_hash(key),
+			value ? string_hash(value) : 0);
+}
+
 /*
  * Gets a value from a map given a key.
  */
 char * map_get(struct map *m, char *key) {
 
-	if (m->node_head == NULL)
+	int i = _map_find(m, key, _hash_string(key));
+	if (i < 0)
 		return NULL;
+	return m->nodes[m->slots[i].index].value;
+}
 
-	struct map_node *current = m->node_head;
-	while (current != NULL) {
-		if (strcmp(current->key, key) == 0)
-			return current->value;
-		current = current->next;
-	}
-	return NULL;
+char * map_get_str(struct map *m, char *key) {
+
+	int i = _map_find(m, key, string_hash(key));
+	if (i < 0)
+		return NULL;
+	return m->nodes[m->slots[i].index].value;
 }
 
 /*
@@ -79,16 +516,12 @@ char * map_get(struct map *m, char *key) {
  */
 int contains_key(struct map *m, char *key) {
 
-	if (m->node_head == NULL)
-		return 0;
+	return _map_find(m, key, _hash_string(key)) >= 0;
+}
 
-	struct map_node *current = m->node_head;
-	while (current != NULL) {
-		if (strcmp(current->key, key) == 0)
-			return 1;
-		current = current->next;
-	}
-	return 0;
+int contains_key_str(struct map *m, char *key) {
+
+	return _map_find(m, key, string_hash(key)) >= 0;
 }
 
 /*
@@ -97,90 +530,90 @@ int contains_key(struct map *m, char *key) {
  */
 int contains_value(struct map *m, char *value) {
 
-	if (m->node_head == NULL)
-		return 0;
-
-	struct map_node *current = m->node_head;
-	while (current != NULL) {
-		if (strcmp(current->value, value) == 0)
+	int i;
+	for (i = 0; i < m->used; ++i) {
+		if (m->nodes[i].key != NULL && strcmp(m->nodes[i].value, value) == 0)
 			return 1;
-		current = current->next;
 	}
 	return 0;
 }
 
 /*
- * Removes a node from a map.
- * Returns a 1 if successful and a 0 otherwise.
- * (e.g. empty list, list does not contain key)
+ * Removes the node in slot i, if i is not -1.
  */
-int remove_node(struct map *m, char *key) {
+static int _map_remove(struct map *m, int i) {
 
-	if (m->node_head == NULL)
+	if (i < 0)
 		return 0;
 
-	if (contains_key(m, key) == 0)
-		return 0;
+	struct map_node *n = &m->nodes[m->slots[i].index];
+	m->fingerprint -= _entry_hash(n->hash, n->value_hash);
+	n->key = NULL;
+	m->slots[i].index = MAP_SLOT_REMOVED;
+	m->size -= 1;
+	return 1;
+}
 
-	struct map_node *current = m->node_head;
-	struct map_node *prev = NULL;
+/*
+ * Removes a node from a map.
+ * Returns a 1 if successful and a 0 otherwise.
+ * (e.g. empty list, list does not contain key)
+ */
+int remove_node(struct map *m, char *key) {
 
-	while (current != NULL) {
+	return _map_remove(m, _map_find(m, key, _hash_string(key)));
+}
 
-		if (strcmp(current->key, key) == 0) {
-			/* removing the head of the list */
-			if (current == m->node_head) {
-				m->node_head = current->next;
-				m->size -= 1;
-				return 1;
-			}
-			prev->next = current->next;
-			m->size -= 1;
-			return 1;
-		}
+int remove_node_str(struct map *m, char *key) {
 
-		if (prev == NULL) prev = m->node_head;
-		else prev = prev->next;
-		current = current->next;
-	}
-	return 1;
+	return _map_remove(m, _map_find(m, key, string_hash(key)));
 }
 
 /*
  * Compares two maps for equality.
+ * Different fingerprints settle it at once; otherwise every pair
+ * of m1 is looked up in m2, comparing value contents.
  */
 int is_equal(struct map *m1, struct map *m2) {
 
-	if (m1->size != m2->size)
+	if (m1 == m2)
+		return 1;
+	if (m1->size != m2->size || m1->fingerprint != m2->fingerprint)
 		return 0;
 
-	struct map_node *c1 = m1->node_head;
-	while (c1 != NULL) {
-		if (contains_key(m2, c1->key) == 0)
+	int i;
+	for (i = 0; i < m1->used; ++i) {
+		struct map_node *n = &m1->nodes[i];
+		if (n->key == NULL)
+			continue;
+		int j = _map_find(m2, n->key, n->hash);
+		if (j < 0)
 			return 0;
-		if (map_get(m2, c1->key) != c1-> value)
+		struct map_node *o = &m2->nodes[m2->slots[j].index];
+		if (o->value == n->value)
+			continue;
+		if (o->value_hash != n->value_hash || o->value == NULL || n->value == NULL
+				|| strcmp(o->value, n->value) != 0)
 			return 0;
-		c1 = c1->next;
 	}
 	return 1;
 }
 
+/*
+ * Returns the fingerprint of a map.
+ */
+unsigned int map_fingerprint(struct map *m) {
+
+	return m->fingerprint;
+}
+
 /*
  * Frees allocated memory for a map.
  */
 void free_map(struct map *m) {
 
-	if (m->node_head != NULL) {
-		/* free all individual nodes */
-		struct map_node *current = m->node_head;
-		struct map_node *after;
-
-		while (current != NULL) {
-			after = current->next;
-			free(current);
-			current = after;
-		}
-	}
+	if (m->capacity > 0)
+		_map_table_free(m->nodes, m->capacity);
 	free(m);
 }
 
@@ -190,19 +623,23 @@ void free_map(struct map *m) {
  *  "michal" : "language guru",
  *  "emily" : "tester"
  * }
+ * Most recently put entries come first.
  */
  void printm(struct map *m) {
  	printf("{\n");
 
-	struct map_node *current = m->node_head;
-	while (current != NULL) {
+	int printed = 0;
+	int i;
+	for (i = m->used - 1; i >= 0; --i) {
+		struct map_node *current = &m->nodes[i];
+		if (current->key == NULL)
+			continue;
 
 		printf("\t\"%s\" : \"%s\"", current->key, current->value);
-		if (current->next != NULL)
+		if (++printed < m->size)
 			printf(",\n");
 		else
 			printf("\n");
-		current = current->next;
 	}
 
 	printf("}\n");
@@ -212,745 +649,4331 @@ void free_map(struct map *m) {
  * GRAPH METHODS
  */
 
+#define VERTEX_INDEX_MIN_CAPACITY 16
+#define VERTEX_MIN_CAPACITY 8
+#define EDGE_MIN_CAPACITY 4
+#define EDGE_SET_MIN_CAPACITY 32
+#define EDGE_SET_THRESHOLD 8
+#define LABEL_MIN_CAPACITY 8
+#define ATTR_INDEX_MIN_CAPACITY 16
+#define GRAPH_PARALLEL_THRESHOLD 65536
+
 /*
- * decides whether a graph should be modified or a node/edge should be deleted
+ * Hashes a map pointer into a vertex index slot.
  */
+static unsigned int _hash_pointer(const void *p) {
 
-struct graph *new_graph()
-{
+    unsigned long long x = (unsigned long long) (size_t) p;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return (unsigned int) x;
+}
 
-    // Make sure you get correct parameters...
-    struct graph * n = malloc(sizeof(struct graph));
-    if(n == NULL)
-    {
-        printf("malloc failed!\n");
-        return NULL;
-    }
-    n -> vertex_count = 0;
-    n -> edge_count = 0;
-    n -> vertex_head = NULL;
-    return n;
+/*
+ * Returns the slot holding key, or the empty slot where it would go.
+ */
+static int _index_slot(struct vertex_index *idx, struct map *key) {
 
+    int mask = idx->capacity - 1;
+    int i = _hash_pointer(key) & mask;
+    while (idx->keys[i] != NULL && idx->keys[i] != key)
+        i = (i + 1) & mask;
+    return i;
 }
 
+/*
+ * Returns the id stored for key, or -1 if key is not indexed.
+ */
+static int _index_get(struct vertex_index *idx, struct map *key) {
 
-struct vertex * _new_vertex(struct map *data)
-{
+    if (idx->capacity == 0)
+        return -1;
+    int i = _index_slot(idx, key);
+    return idx->keys[i] ? idx->ids[i] : -1;
+}
 
-	struct vertex * new_vertex = malloc(sizeof(struct vertex));
-    if(new_vertex == NULL){
-        printf("malloc failed at build new node\n");
-        return NULL;
-    }
+/*
+ * Rehashes the index into a table of the given capacity.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _index_resize(struct vertex_index *idx, int capacity) {
 
-	//do we need a void star cast??
-    new_vertex -> connected_edges = NULL;
-    new_vertex -> next_vertex = NULL;
-    new_vertex -> data = data;
+    struct map **keys = calloc(capacity, sizeof(struct map *));
+    int *ids = malloc(capacity * sizeof(int));
+    if (keys == NULL || ids == NULL) {
+        free(keys);
+        free(ids);
+        return 0;
+    }
 
-	return new_vertex;
+    struct vertex_index bigger = { keys, ids, idx->size, capacity };
+    int i;
+    for (i = 0; i < idx->capacity; ++i) {
+        if (idx->keys[i] == NULL)
+            continue;
+        int j = _index_slot(&bigger, idx->keys[i]);
+        keys[j] = idx->keys[i];
+        ids[j] = idx->ids[i];
+    }
 
+    free(idx->keys);
+    free(idx->ids);
+    *idx = bigger;
+    return 1;
 }
 
-struct edge * _new_edge(struct vertex *a, struct vertex *b, char *data)
-{
+/*
+ * Maps key to id, replacing any previous entry.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _index_put(struct vertex_index *idx, struct map *key, int id) {
 
-    struct edge *current = malloc(sizeof(struct edge));
+    if ((idx->size + 1) * 4 > idx->capacity * 3) {
+        int capacity = idx->capacity ? idx->capacity * 2 : VERTEX_INDEX_MIN_CAPACITY;
+        if (!_index_resize(idx, capacity))
+            return 0;
+    }
 
-    if(current == NULL){
-        printf("malloc failed at build new node\n");
-        return NULL;
+    int i = _index_slot(idx, key);
+    if (idx->keys[i] == NULL) {
+        idx->keys[i] = key;
+        ++(idx->size);
     }
+    idx->ids[i] = id;
+    return 1;
+}
 
-    current -> from = a;
-    current -> to = b;
-    current -> next = 0;
-    current -> data = data;
+/*
+ * Removes key from the index, shifting later entries of its probe
+ * run back so that lookups never need tombstones.
+ */
+static void _index_remove(struct vertex_index *idx, struct map *key) {
+
+    if (idx->capacity == 0)
+        return;
 
-    return current;
+    int mask = idx->capacity - 1;
+    int i = _index_slot(idx, key);
+    if (idx->keys[i] == NULL)
+        return;
 
+    int j = i;
+    while (1) {
+        j = (j + 1) & mask;
+        if (idx->keys[j] == NULL)
+            break;
+        int home = _hash_pointer(idx->keys[j]) & mask;
+        /* move j into the hole at i unless its home lies in (i, j] */
+        if ((j > i && (home <= i || home > j)) || (j < i && (home <= i && home > j))) {
+            idx->keys[i] = idx->keys[j];
+            idx->ids[i] = idx->ids[j];
+            i = j;
+        }
+    }
+    idx->keys[i] = NULL;
+    --(idx->size);
 }
 
-void modify_graph(struct graph *g, struct map * a, char *w, struct map *b, int d) {
-    if(d == 0){
-    /*checks to see if B has data in it, if it does:*/
-        if(b){
-        //add vertices into graph if they are not already in it
-            if(!get_vertex(g,a)) { add_vertex(g,a); }
-	    if(!get_vertex(g,b)) { add_vertex(g,b); }
+static void _index_free(struct vertex_index *idx) {
 
-        //if the edge doens't exist then add the edge, otherwise modify it
-            if(_find_edge(g,a,b) == 0){
-                if(w == 0) { w = ""; }
-                _add_edge(g,a,b,w);
-            }
-	    else {
-                if(w == 0) { w = ""; }
-                _modify_edge(g,a,b,w);
+    free(idx->keys);
+    free(idx->ids);
+    idx->keys = NULL;
+    idx->ids = NULL;
+    idx->size = 0;
+    idx->capacity = 0;
+}
+
+/*
+ * Hashes a vertex id into an edge set slot.
+ */
+static unsigned int _hash_id(int id) {
+
+    unsigned int h = (unsigned int) id * 2654435761u;
+    return h ^ (h >> 16);
+}
+
+/*
+ * Returns the slot holding target 'to', or the empty slot where it would go.
+ */
+static int _edge_set_slot(struct edge_set *set, int to) {
+
+    int mask = set->capacity - 1;
+    int i = _hash_id(to) & mask;
+    while (set->targets[i] >= 0 && set->targets[i] != to)
+        i = (i + 1) & mask;
+    return i;
+}
+
+/*
+ * Records that the edge to 'to' sits at position pos of the vertex's
+ * edge array, growing the set first if needed.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _edge_set_put(struct edge_set *set, int to, int pos) {
+
+    if ((set->size + 1) * 2 > set->capacity) {
+        int capacity = set->capacity * 2;
+        int *targets = malloc(capacity * sizeof(int));
+        int *positions = malloc(capacity * sizeof(int));
+        if (targets == NULL || positions == NULL) {
+            free(targets);
+            free(positions);
+            return 0;
+        }
+
+        struct edge_set bigger = { targets, positions, set->size, capacity };
+        int i;
+        for (i = 0; i < capacity; ++i)
+            targets[i] = -1;
+        for (i = 0; i < set->capacity; ++i) {
+            if (set->targets[i] < 0)
+                continue;
+            int j = _edge_set_slot(&bigger, set->targets[i]);
+            targets[j] = set->targets[i];
+            positions[j] = set->positions[i];
+        }
+
+        free(set->targets);
+        free(set->positions);
+        *set = bigger;
+    }
+
+    int i = _edge_set_slot(set, to);
+    if (set->targets[i] < 0) {
+        set->targets[i] = to;
+        ++(set->size);
+    }
+    set->positions[i] = pos;
+    return 1;
+}
+
+/*
+ * Removes target 'to' from the set by backward shifting its probe run.
+ */
+static void _edge_set_remove(struct edge_set *set, int to) {
+
+    int mask = set->capacity - 1;
+    int i = _edge_set_slot(set, to);
+    if (set->targets[i] < 0)
+        return;
+
+    int j = i;
+    while (1) {
+        j = (j + 1) & mask;
+        if (set->targets[j] < 0)
+            break;
+        int home = _hash_id(set->targets[j]) & mask;
+        if ((j > i && (home <= i || home > j)) || (j < i && (home <= i && home > j))) {
+            set->targets[i] = set->targets[j];
+            set->positions[i] = set->positions[j];
+            i = j;
+        }
+    }
+    set->targets[i] = -1;
+    --(set->size);
+}
+
+static void _edge_set_free(struct edge_set *set) {
+
+    if (set) {
+        free(set->targets);
+        free(set->positions);
+        free(set);
+    }
+}
+
+/*
+ * Returns an empty edge set with room for n entries, or NULL if out of memory.
+ */
+static struct edge_set * _edge_set_make(int n) {
+
+    struct edge_set *set = malloc(sizeof(struct edge_set));
+    int capacity = EDGE_SET_MIN_CAPACITY;
+    while (capacity < 2 * n)
+        capacity *= 2;
+    if (set) {
+        set -> targets = malloc(capacity * sizeof(int));
+        set -> positions = malloc(capacity * sizeof(int));
+        set -> size = 0;
+        set -> capacity = capacity;
+    }
+    if (set == NULL || set -> targets == NULL || set -> positions == NULL) {
+        _edge_set_free(set);
+        return NULL;
+    }
+
+    int i;
+    for (i = 0; i < capacity; ++i)
+        set -> targets[i] = -1;
+    return set;
+}
+
+/*
+ * Builds the edge set of a vertex from its live edges.
+ * Leaves targets NULL (so lookups fall back to a scan) if out of memory.
+ */
+static void _edge_set_build(struct vertex *v) {
+
+    _edge_set_free(v -> targets);
+    v -> targets = _edge_set_make(v -> degree);
+    if (v -> targets == NULL)
+        return;
+
+    struct edge_set *set = v -> targets;
+    int i;
+    for (i = 0; i < v -> edge_slots; ++i) {
+        int to = v -> connected_edges[i].to;
+        if (to >= 0) {
+            int j = _edge_set_slot(set, to);
+            set -> targets[j] = to;
+            set -> positions[j] = i;
+            ++(set -> size);
+        }
+    }
+}
+
+/*
+ * Builds the set of the sources of a vertex's in-edges, mapping each
+ * to its position in in_edges. Leaves sources NULL if out of memory.
+ */
+static void _source_set_build(struct vertex *v) {
+
+    _edge_set_free(v -> sources);
+    v -> sources = _edge_set_make(v -> in_degree);
+    if (v -> sources == NULL)
+        return;
+
+    struct edge_set *set = v -> sources;
+    int i;
+    for (i = 0; i < v -> in_degree; ++i) {
+        int j = _edge_set_slot(set, v -> in_edges[i]);
+        set -> targets[j] = v -> in_edges[i];
+        set -> positions[j] = i;
+        ++(set -> size);
+    }
+}
+
+/*
+ * Edge labels.
+ */
+
+static void _label_dict_init(struct label_dict *d)
+{
+
+    d -> names = NULL;
+    d -> hashes = NULL;
+    d -> weights = NULL;
+    d -> count = 0;
+    d -> capacity = 0;
+    d -> slots = NULL;
+    d -> slot_capacity = 0;
+    d -> last = -1;
+
+}
+
+static void _label_dict_free(struct label_dict *d)
+{
+
+    free(d -> names);
+    free(d -> hashes);
+    free(d -> weights);
+    free(d -> slots);
+    _label_dict_init(d);
+
+}
+
+/*
+ * Reads a label as an edge weight: the number it spells, or 1 if it
+ * is not a number. "inf" reads as HUGE_VAL, which searches treat as
+ * no edge; negative and NaN weights are kept so they can be reported.
+ */
+static double _parse_weight(char *name)
+{
+
+    char *end;
+    double w = strtod(name, &end);
+    return end != name && *end == '\0' ? w : 1.0;
+
+}
+
+static int _label_id(struct label_dict *d, char *name, int add)
+{
+
+    if (name == 0){
+        return -1;
+    }
+    if (d -> last >= 0 && d -> names[d -> last] == name){
+        return d -> last;
+    }
+
+    unsigned int hash = _hash_string(name);
+    int mask = d -> slot_capacity - 1;
+    int i = hash & mask;
+    if (d -> slot_capacity > 0){
+        while (d -> slots[i] >= 0){
+            int id = d -> slots[i];
+            if (d -> hashes[id] == hash && (d -> names[id] == name || strcmp(d -> names[id], name) == 0)){
+                d -> last = id;
+                return id;
+            }
+            i = (i + 1) & mask;
+        }
+    }
+    if (!add){
+        return -1;
+    }
+
+    if (d -> count == d -> capacity){
+        int capacity = d -> capacity ? 2 * d -> capacity : LABEL_MIN_CAPACITY;
+        char **names = realloc(d -> names, capacity * sizeof(char *));
+        if (names) { d -> names = names; }
+        unsigned int *hashes = realloc(d -> hashes, capacity * sizeof(unsigned int));
+        if (hashes) { d -> hashes = hashes; }
+        double *weights = realloc(d -> weights, capacity * sizeof(double));
+        if (weights) { d -> weights = weights; }
+        if (names == NULL || hashes == NULL || weights == NULL){
+            printf("malloc failed at adding a label\n");
+            return -1;
+        }
+        d -> capacity = capacity;
+    }
+
+    //keep the table at most half full
+    if (2 * (d -> count + 1) > d -> slot_capacity){
+        int capacity = d -> slot_capacity ? 2 * d -> slot_capacity : 2 * LABEL_MIN_CAPACITY;
+        int *slots = malloc(capacity * sizeof(int));
+        if (slots == NULL){
+            printf("malloc failed at adding a label\n");
+            return -1;
+        }
+        free(d -> slots);
+        d -> slots = slots;
+        d -> slot_capacity = capacity;
+        mask = capacity - 1;
+        int k;
+        for (k = 0; k < capacity; ++k){
+            slots[k] = -1;
+        }
+        for (k = 0; k < d -> count; ++k){
+            int j = d -> hashes[k] & mask;
+            while (slots[j] >= 0){
+                j = (j + 1) & mask;
+            }
+            slots[j] = k;
+        }
+        i = hash & mask;
+        while (slots[i] >= 0){
+            i = (i + 1) & mask;
+        }
+    }
+
+    int id = (d -> count)++;
+    d -> names[id] = name;
+    d -> hashes[id] = hash;
+    d -> weights[id] = _parse_weight(name);
+    d -> slots[i] = id;
+    d -> last = id;
+    return id;
+
+}
+
+/*
+ * Returns the data of an edge of g.
+ */
+static char * _edge_label(struct graph *g, struct edge *e)
+{
+
+    return e -> label < 0 ? NULL : g -> labels.names[e -> label];
+
+}
+
+/*
+ * ids[k] = the id in g of the label with id k in h, adding the labels
+ * g does not have yet. Returns NULL if memory ran out.
+ */
+static int * _translate_labels(struct graph *g, struct graph *h)
+{
+
+    int *ids = malloc((h -> labels.count + 1) * sizeof(int));
+    if (ids == NULL){
+        return NULL;
+    }
+    int k;
+    for (k = 0; k < h -> labels.count; ++k){
+        ids[k] = _label_id(&g -> labels, h -> labels.names[k], 1);
+    }
+    return ids;
+
+}
+
+static void _label_groups_free(struct vertex *v)
+{
+
+    if (v -> groups){
+        free(v -> groups -> labels);
+        free(v -> groups -> offsets);
+        free(v -> groups -> positions);
+        free(v -> groups);
+        v -> groups = NULL;
+    }
+
+}
+
+/*
+ * Orders edge positions by label, then position.
+ */
+struct label_position {
+
+    int label;
+    int pos;
+
+};
+
+static int _compare_label_positions(const void *a, const void *b)
+{
+
+    const struct label_position *x = a, *y = b;
+    if (x -> label != y -> label){
+        return x -> label < y -> label ? -1 : 1;
+    }
+    return x -> pos - y -> pos;
+
+}
+
+/*
+ * Builds v's label groups; see struct label_groups.
+ * Returns NULL if memory ran out.
+ */
+static struct label_groups * _label_groups_build(struct vertex *v)
+{
+
+    struct label_groups *groups = malloc(sizeof(struct label_groups));
+    struct label_position *order = malloc((v -> degree + 1) * sizeof(struct label_position));
+    if (groups){
+        groups -> labels = malloc((v -> degree + 1) * sizeof(int));
+        groups -> offsets = malloc((v -> degree + 2) * sizeof(int));
+        groups -> positions = malloc((v -> degree + 1) * sizeof(int));
+    }
+    if (groups == NULL || order == NULL || groups -> labels == NULL ||
+            groups -> offsets == NULL || groups -> positions == NULL){
+        if (groups){
+            free(groups -> labels);
+            free(groups -> offsets);
+            free(groups -> positions);
+            free(groups);
+        }
+        free(order);
+        return NULL;
+    }
+
+    int i, n = 0;
+    for (i = 0; i < v -> edge_slots; ++i){
+        if (v -> connected_edges[i].to >= 0){
+            order[n].label = v -> connected_edges[i].label;
+            order[n].pos = i;
+            ++n;
+        }
+    }
+    qsort(order, n, sizeof(struct label_position), _compare_label_positions);
+
+    groups -> count = 0;
+    for (i = 0; i < n; ++i){
+        if (i == 0 || order[i].label != order[i - 1].label){
+            groups -> labels[groups -> count] = order[i].label;
+            groups -> offsets[(groups -> count)++] = i;
+        }
+        groups -> positions[i] = order[i].pos;
+    }
+    groups -> offsets[groups -> count] = n;
+
+    free(order);
+    return groups;
+
+}
+
+/*
+ * Returns the position of the edge to 'to' in v's edge array, or -1.
+ * Small vertices are scanned, larger ones probe their edge set.
+ */
+static int _edge_position(struct vertex *v, int to) {
+
+    if (v -> targets) {
+        int i = _edge_set_slot(v -> targets, to);
+        return v -> targets -> targets[i] < 0 ? -1 : v -> targets -> positions[i];
+    }
+
+    int i;
+    for (i = 0; i < v -> edge_slots; ++i) {
+        if (v -> connected_edges[i].to == to)
+            return i;
+    }
+    return -1;
+}
+
+/*
+ * Squeezes deleted edges out of v's edge array, keeping the order of
+ * the live ones, and rebuilds the edge set around the new positions.
+ */
+static void _compact_edges(struct vertex *v) {
+
+    int i, n = 0;
+    for (i = 0; i < v -> edge_slots; ++i) {
+        if (v -> connected_edges[i].to >= 0)
+            v -> connected_edges[n++] = v -> connected_edges[i];
+    }
+    v -> edge_slots = n;
+
+    if (v -> targets)
+        _edge_set_build(v);
+}
+
+/*
+ * Removes the edge at position pos of v's edge array.
+ * The slot is marked dead and reclaimed once dead slots outnumber live ones.
+ */
+static void _remove_edge_at(struct vertex *v, int pos) {
+
+    if (v -> targets)
+        _edge_set_remove(v -> targets, v -> connected_edges[pos].to);
+
+    v -> connected_edges[pos].to = -1;
+    v -> connected_edges[pos].label = -1;
+    --(v -> degree);
+    v -> nth_index = -1;
+    _label_groups_free(v);
+
+    if (pos == v -> edge_slots - 1)
+        --(v -> edge_slots);
+    else if (v -> edge_slots - v -> degree > v -> degree)
+        _compact_edges(v);
+}
+
+/*
+ * Drops the frozen snapshot of g, if any. Called before every change to g.
+ */
+static void _unfreeze_graph(struct graph *g)
+{
+
+    if (g -> frozen){
+        struct csr_graph *c = g -> frozen;
+        free(c -> offsets);
+        free(c -> targets);
+        free(c -> edge_data);
+        free(c -> vertex_data);
+        free(c);
+        g -> frozen = NULL;
+    }
+
+}
+
+/*
+ * Makes room for n more in-edges of v, growing the array in one step.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _reserve_in_edges(struct vertex *v, int n)
+{
+
+    if (v -> in_degree + n > v -> in_capacity){
+        int capacity = v -> in_capacity ? 2 * v -> in_capacity : EDGE_MIN_CAPACITY;
+        while (capacity < v -> in_degree + n){
+            capacity *= 2;
+        }
+        int *in_edges = realloc(v -> in_edges, capacity * sizeof(int));
+        if (in_edges == NULL){
+            return 0;
+        }
+        v -> in_edges = in_edges;
+        v -> in_capacity = capacity;
+    }
+    return 1;
+
+}
+
+/*
+ * Records that vertex 'from' has an edge to v.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _add_in_edge(struct vertex *v, int from)
+{
+
+    if (!_reserve_in_edges(v, 1)){
+        return 0;
+    }
+    int pos = (v -> in_degree)++;
+    v -> in_edges[pos] = from;
+
+    //past the threshold, keep a set of sources like the out-edges do
+    if (v -> sources){
+        if (!_edge_set_put(v -> sources, from, pos)){
+            _edge_set_free(v -> sources);
+            v -> sources = NULL;
+        }
+    }
+    else if (v -> in_degree > EDGE_SET_THRESHOLD){
+        _source_set_build(v);
+    }
+    return 1;
+
+}
+
+/*
+ * Forgets the edge from vertex 'from' to v. The last in-edge takes
+ * its place, so the others do not move.
+ */
+static void _remove_in_edge(struct vertex *v, int from)
+{
+
+    int i;
+    if (v -> sources){
+        int slot = _edge_set_slot(v -> sources, from);
+        if (v -> sources -> targets[slot] < 0){
+            return;
+        }
+        i = v -> sources -> positions[slot];
+        _edge_set_remove(v -> sources, from);
+    }
+    else {
+        for (i = v -> in_degree - 1; i >= 0 && v -> in_edges[i] != from; --i);
+        if (i < 0){
+            return;
+        }
+    }
+
+    int last = v -> in_edges[--(v -> in_degree)];
+    if (i < v -> in_degree){
+        v -> in_edges[i] = last;
+        if (v -> sources){
+            v -> sources -> positions[_edge_set_slot(v -> sources, last)] = i;
+        }
+    }
+
+}
+
+/*
+ * Attribute indexes.
+ */
+
+/*
+ * Returns the slot of value's bucket in idx, or of the empty slot
+ * where it would go. idx must have room.
+ */
+static int _attr_bucket_slot(struct attr_index *idx, char *value, unsigned int hash)
+{
+
+    int mask = idx -> capacity - 1;
+    int i = hash & mask;
+    while (idx -> buckets[i].value){
+        struct attr_bucket *b = &idx -> buckets[i];
+        if (b -> hash == hash && (b -> value == value || strcmp(b -> value, value) == 0)){
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+    return i;
+
+}
+
+/*
+ * Doubles idx's bucket table, keeping it at most half full, and moves
+ * the bucket slots of the ids filed in it along.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _attr_index_grow(struct attr_index *idx)
+{
+
+    int capacity = idx -> capacity ? 2 * idx -> capacity : ATTR_INDEX_MIN_CAPACITY;
+    struct attr_bucket *buckets = calloc(capacity, sizeof(struct attr_bucket));
+    if (buckets == NULL){
+        return 0;
+    }
+
+    struct attr_bucket *old = idx -> buckets;
+    int old_capacity = idx -> capacity, i, j;
+    idx -> buckets = buckets;
+    idx -> capacity = capacity;
+    for (i = 0; i < old_capacity; ++i){
+        if (old[i].value){
+            int slot = _attr_bucket_slot(idx, old[i].value, old[i].hash);
+            buckets[slot] = old[i];
+            for (j = 0; j < old[i].count; ++j){
+                idx -> id_buckets[old[i].ids[j]] = slot;
+            }
+        }
+    }
+    free(old);
+    return 1;
+
+}
+
+/*
+ * Makes room in idx's per-id arrays for vertex id.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _attr_index_reserve_id(struct attr_index *idx, int id)
+{
+
+    if (id < idx -> id_capacity){
+        return 1;
+    }
+    int capacity = idx -> id_capacity ? 2 * idx -> id_capacity : EDGE_MIN_CAPACITY;
+    while (capacity <= id){
+        capacity *= 2;
+    }
+    int *id_buckets = realloc(idx -> id_buckets, capacity * sizeof(int));
+    if (id_buckets == NULL){
+        return 0;
+    }
+    idx -> id_buckets = id_buckets;
+    int *id_positions = realloc(idx -> id_positions, capacity * sizeof(int));
+    if (id_positions == NULL){
+        return 0;
+    }
+    idx -> id_positions = id_positions;
+
+    int i;
+    for (i = idx -> id_capacity; i < capacity; ++i){
+        id_buckets[i] = -1;
+    }
+    idx -> id_capacity = capacity;
+    return 1;
+
+}
+
+/*
+ * Takes vertex id out of idx, if it is filed there. The id's bucket
+ * is the one it was filed in, whatever its map holds now; the last id
+ * of the bucket takes its place.
+ */
+static void _attr_index_remove(struct attr_index *idx, int id)
+{
+
+    if (id >= idx -> id_capacity || idx -> id_buckets[id] < 0){
+        return;
+    }
+
+    struct attr_bucket *b = &idx -> buckets[idx -> id_buckets[id]];
+    int pos = idx -> id_positions[id];
+    int last = b -> ids[--(b -> count)];
+    b -> ids[pos] = last;
+    idx -> id_positions[last] = pos;
+    idx -> id_buckets[id] = -1;
+
+}
+
+/*
+ * Files vertex id, whose map is data, under its value for idx's key.
+ */
+static void _attr_index_add(struct attr_index *idx, int id, struct map *data)
+{
+
+    char *value = map_get(data, idx -> key);
+    if (value == 0){
+        return;
+    }
+    if (!_attr_index_reserve_id(idx, id)){
+        printf("malloc failed at indexing a vertex\n");
+        return;
+    }
+    _attr_index_remove(idx, id);
+    if (2 * (idx -> size + 1) > idx -> capacity && !_attr_index_grow(idx)){
+        printf("malloc failed at indexing a vertex\n");
+        return;
+    }
+
+    unsigned int hash = _hash_string(value);
+    int slot = _attr_bucket_slot(idx, value, hash);
+    struct attr_bucket *b = &idx -> buckets[slot];
+    if (b -> value == 0){
+        b -> value = value;
+        b -> hash = hash;
+        ++(idx -> size);
+    }
+    if (b -> count == b -> capacity){
+        int capacity = b -> capacity ? 2 * b -> capacity : EDGE_MIN_CAPACITY;
+        int *ids = realloc(b -> ids, capacity * sizeof(int));
+        if (ids == NULL){
+            printf("malloc failed at indexing a vertex\n");
+            return;
+        }
+        b -> ids = ids;
+        b -> capacity = capacity;
+    }
+    idx -> id_buckets[id] = slot;
+    idx -> id_positions[id] = b -> count;
+    b -> ids[(b -> count)++] = id;
+
+}
+
+static void _attr_index_free(struct attr_index *idx)
+{
+
+    int i;
+    for (i = 0; i < idx -> capacity; ++i){
+        free(idx -> buckets[i].ids);
+    }
+    free(idx -> buckets);
+    free(idx -> id_buckets);
+    free(idx -> id_positions);
+    free(idx);
+
+}
+
+/*
+ * Drops g's attribute column store, if any.
+ */
+static void _drop_columns(struct graph *g)
+{
+
+    if (g -> columns){
+        int k;
+        for (k = 0; k < g -> columns -> count; ++k){
+            free(g -> columns -> columns[k].values);
+        }
+        free(g -> columns -> columns);
+        free(g -> columns -> fingerprints);
+        free(g -> columns);
+        g -> columns = NULL;
+    }
+
+}
+
+static int _compare_ids(const void *a, const void *b)
+{
+
+    return *(const int *) a - *(const int *) b;
+
+}
+
+/*
+ * decides whether a graph should be modified or a node/edge should be deleted
+ */
+
+struct graph *new_graph()
+{
+
+    // Make sure you get correct parameters...
+    struct graph * n = malloc(sizeof(struct graph));
+    if(n == NULL)
+    {
+        printf("malloc failed!\n");
+        return NULL;
+    }
+    n -> vertex_count = 0;
+    n -> edge_count = 0;
+    n -> vertices = NULL;
+    n -> vertex_slots = 0;
+    n -> vertex_capacity = 0;
+    n -> free_ids = NULL;
+    n -> free_count = 0;
+    n -> index.keys = NULL;
+    n -> index.ids = NULL;
+    n -> index.size = 0;
+    n -> index.capacity = 0;
+    n -> frozen = NULL;
+    _label_dict_init(&n -> labels);
+    n -> columns = NULL;
+    n -> attr_indexes = NULL;
+    int k;
+    for (k = 0; k < EDGE_SLAB_CLASSES; ++k){
+        slab_init(&n -> edge_slabs[k], (EDGE_MIN_CAPACITY << k) * sizeof(struct edge));
+    }
+    return n;
+
+}
+
+/*
+ * Hands out an id for a new vertex holding data, reusing a deleted
+ * slot when there is one. Returns -1 if allocation fails.
+ */
+static int _new_vertex(struct graph *g, struct map *data)
+{
+
+    int id;
+    if (g -> free_count > 0){
+        id = g -> free_ids[--(g -> free_count)];
+    }
+    else {
+        if (g -> vertex_slots == g -> vertex_capacity){
+            int capacity = g -> vertex_capacity ? 2 * g -> vertex_capacity : VERTEX_MIN_CAPACITY;
+            struct vertex *vertices = realloc(g -> vertices, capacity * sizeof(struct vertex));
+            int *free_ids = realloc(g -> free_ids, capacity * sizeof(int));
+            if (vertices) { g -> vertices = vertices; }
+            if (free_ids) { g -> free_ids = free_ids; }
+            if (vertices == NULL || free_ids == NULL){
+                printf("malloc failed at build new node\n");
+                return -1;
+            }
+            g -> vertex_capacity = capacity;
+        }
+        id = (g -> vertex_slots)++;
+    }
+
+    struct vertex *v = &g -> vertices[id];
+    v -> connected_edges = NULL;
+    v -> edge_slots = 0;
+    v -> edge_capacity = 0;
+    v -> degree = 0;
+    v -> targets = NULL;
+    v -> in_edges = NULL;
+    v -> sources = NULL;
+    v -> nth_index = -1;
+    v -> in_degree = 0;
+    v -> in_capacity = 0;
+    v -> groups = NULL;
+    v -> data = data;
+
+    return id;
+
+}
+
+/*
+ * Allocates an edge array of the given capacity, from the graph's
+ * slabs if it is small enough. Returns NULL if out of memory.
+ */
+static struct edge * _edge_array_alloc(struct graph *g, int capacity)
+{
+
+    int k;
+    for (k = 0; k < EDGE_SLAB_CLASSES; ++k){
+        if (capacity == EDGE_MIN_CAPACITY << k){
+            return slab_alloc(&g -> edge_slabs[k]);
+        }
+    }
+    return malloc(capacity * sizeof(struct edge));
+
+}
+
+static void _edge_array_free(struct graph *g, struct edge *edges, int capacity)
+{
+
+    int k;
+    for (k = 0; k < EDGE_SLAB_CLASSES; ++k){
+        if (capacity == EDGE_MIN_CAPACITY << k){
+            slab_free(&g -> edge_slabs[k], edges);
+            return;
+        }
+    }
+    free(edges);
+
+}
+
+/*
+ * Makes room for n more edges in v's edge array, growing it in one step.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _reserve_edges(struct graph *g, struct vertex *v, int n)
+{
+
+    if (v -> edge_slots + n > v -> edge_capacity){
+        int capacity = v -> edge_capacity ? 2 * v -> edge_capacity : EDGE_MIN_CAPACITY;
+        while (capacity < v -> edge_slots + n){
+            capacity *= 2;
+        }
+        struct edge *edges;
+        if (v -> edge_capacity > (EDGE_MIN_CAPACITY << (EDGE_SLAB_CLASSES - 1))){
+            edges = realloc(v -> connected_edges, capacity * sizeof(struct edge));
+        }
+        else {
+            edges = _edge_array_alloc(g, capacity);
+            if (edges && v -> edge_slots > 0){
+                memcpy(edges, v -> connected_edges, v -> edge_slots * sizeof(struct edge));
+            }
+            if (edges && v -> edge_capacity > 0){
+                _edge_array_free(g, v -> connected_edges, v -> edge_capacity);
+            }
+        }
+        if(edges == NULL){
+            printf("malloc failed at build new node\n");
+            return 0;
+        }
+        v -> connected_edges = edges;
+        v -> edge_capacity = capacity;
+    }
+    return 1;
+
+}
+
+/*
+ * Appends an edge from vertex a to vertex b, with the label of id
+ * label, to a's edge array.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _new_edge(struct graph *g, int a, int b, int label)
+{
+
+    struct vertex *v = &g -> vertices[a];
+
+    if (!_reserve_edges(g, v, 1)){
+        return 0;
+    }
+
+    int pos = (v -> edge_slots)++;
+    struct edge *current = &v -> connected_edges[pos];
+    current -> from = a;
+    current -> to = b;
+    current -> label = label;
+    ++(v -> degree);
+    _label_groups_free(v);
+
+    //past the threshold, keep a set of targets for O(1) lookups
+    if (v -> targets){
+        if (!_edge_set_put(v -> targets, b, pos)){
+            _edge_set_free(v -> targets);
+            v -> targets = NULL;
+        }
+    }
+    else if (v -> degree > EDGE_SET_THRESHOLD){
+        _edge_set_build(v);
+    }
+
+    return 1;
+
+}
+
+void modify_graph(struct graph *g, struct map * a, char *w, struct map *b, int d) {
+    if(d == 0){
+    /*checks to see if B has data in it, if it does:*/
+        if(b){
+        //add vertices into graph if they are not already in it
+            if(!get_vertex(g,a)) { add_vertex(g,a); }
+	    if(!get_vertex(g,b)) { add_vertex(g,b); }
+
+        //if the edge doens't exist then add the edge, otherwise modify it
+            if(_find_edge(g,a,b) == 0){
+                if(w == 0) { w = EMPTY_STRING; }
+                _add_edge(g,a,b,w);
+            }
+	    else {
+                if(w == 0) { w = EMPTY_STRING; }
+                _modify_edge(g,a,b,w);
+            }
+        }
+	else {
+            add_vertex(g,a);
+        }
+    }
+    else{
+        if(b){
+	    delete_edge(g,a,b);
+        }
+	else{
+            delete_vertex(g,a);
+        }
+    }
+}
+
+/*
+ * Makes data a vertex of g, which it must not already be.
+ * Returns its id, or -1 if memory ran out.
+ */
+static int _insert_vertex(struct graph *g, struct map *data)
+{
+
+    _unfreeze_graph(g);
+
+    //take the next free id and remember which map it belongs to
+    int id = _new_vertex(g, data);
+    if (id < 0){
+        return -1;
+    }
+    if (!_index_put(&g -> index, data, id)){
+        g -> vertices[id].data = 0;
+        g -> free_ids[(g -> free_count)++] = id;
+        return -1;
+    }
+
+    struct attr_index *idx;
+    for (idx = g -> attr_indexes; idx; idx = idx -> next){
+        _attr_index_add(idx, id, data);
+    }
+    _drop_columns(g);
+
+    ++(g -> vertex_count);
+    return id;
+
+}
+
+/*
+ * Adds an edge from vertex a to vertex b, which must not already exist,
+ * with the label of id label.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _link_vertices(struct graph *g, int a, int b, int label)
+{
+
+    _unfreeze_graph(g);
+
+    //append to the end of the vertex's edges
+    if (!_new_edge(g, a, b, label)){
+        return 0;
+    }
+    if (!_add_in_edge(&g -> vertices[b], a)){
+        struct vertex *v = &g -> vertices[a];
+        _remove_edge_at(v, _edge_position(v, b));
+        return 0;
+    }
+
+    ++(g -> edge_count);
+    return 1;
+
+}
+
+/*
+ * Takes the vertex with id 'id' out of g with all of its edges, and
+ * frees its slot for reuse. Its map is left to the caller.
+ */
+static void _remove_vertex(struct graph *g, int id)
+{
+
+    _unfreeze_graph(g);
+
+    struct vertex *v = &g -> vertices[id];
+    int i;
+
+    //unlink the edges pointing at it from their sources
+    for (i = 0; i < v -> in_degree; ++i){
+        int from = v -> in_edges[i];
+        if (from == id){
+            continue;
+        }
+        struct vertex *source = &g -> vertices[from];
+        int pos = _edge_position(source, id);
+        if (pos >= 0){
+            _remove_edge_at(source, pos);
+            --(g -> edge_count);
+        }
+    }
+
+    //and forget its own edges at their targets
+    for (i = 0; i < v -> edge_slots; ++i){
+        int to = v -> connected_edges[i].to;
+        if (to >= 0 && to != id){
+            _remove_in_edge(&g -> vertices[to], id);
+        }
+    }
+
+    struct attr_index *idx;
+    for (idx = g -> attr_indexes; idx; idx = idx -> next){
+        _attr_index_remove(idx, id);
+    }
+    _drop_columns(g);
+
+    _index_remove(&g -> index, v -> data);
+    g -> edge_count -= _free_adjacency_row(g, v);
+    v -> data = 0;
+    g -> free_ids[(g -> free_count)++] = id;
+    --(g -> vertex_count);
+
+}
+
+void add_vertex(struct graph *g, struct map *data){
+
+	if(g == 0){
+		printf("graph not found! add_new_vertex()\n");
+        return ;
+	}
+
+	if (data == 0){
+        printf("vertex not found! add_new_vertex()\n");
+        return ;
+    }
+
+	//a map is at most one vertex of a graph
+	if (_index_get(&g -> index, data) >= 0){
+		return ;
+	}
+
+	_insert_vertex(g, data);
+	return ;
+}
+
+void delete_vertex(struct graph *g, struct map *data)
+{
+
+	if(g == 0){
+        printf("graph not found: delete_vertex()!\n");
+        return;
+    }
+    if(g -> vertex_count == 0){
+        printf("no vertex to delete in: delete_vertex()\n");
+        return;
+    }
+
+	//get the id of the vertex to be deleted
+	int to_delete = _index_get(&g -> index, data);
+
+	if(to_delete < 0){
+		printf("vertex not found\n");
+		return;
+	}
+
+    _remove_vertex(g, to_delete);
+    free_map(data);
+
+    return;
+
+}
+
+/*
+ * finds a vertex given the data and the graph teh vertex  should be in
+ * returns null if no vertex found
+ */
+
+struct vertex * get_vertex(struct graph *g, struct map *data)
+{
+
+    if (g == 0){
+        printf("graph not found. get_vertex() failed.");
+        return 0;
+    }
+
+    if (data == 0){
+        printf("data doesn't exist. get_vertex() failed.");
+        return 0;
+    }
+
+    int id = _index_get(&g -> index, data);
+    return id < 0 ? 0 : &g -> vertices[id];
+
+}
+
+/*
+ * returns the dense id of the vertex holding data, or -1 if there is none
+ */
+int get_vertex_id(struct graph *g, struct map *data)
+{
+
+    if (g == 0 || data == 0){
+        return -1;
+    }
+
+    return _index_get(&g -> index, data);
+
+}
+
+/*
+ * modifies the vertex given the new data, deletes old node from graph g and adds new one to g
+ */
+void modify_vertex(struct graph *g, struct map *old, struct map *new)
+{
+
+    if(g == 0){
+        printf("graph not found. modify_vertex() failed.");
+        return ;
+    }
+
+    if(old == 0){
+        printf("no old data. modify_vertex() failed.");
+        return ;
+    }
+
+    if (new == 0){
+        printf("no new data. modify_vertex() failed.");
+        return ;
+    }
+
+    delete_vertex(g, old);
+    add_vertex(g, new);
+
+    return;
+
+}
+
+/*
+ * add edge function, creates a new edge between two edges, only does it one way
+ * it will make the edge from g to v
+ *
+ */
+void _add_edge(struct graph *g, struct map *v, struct map *f, char *data)
+{
+
+    if (g == 0){
+        printf("graph not found. failed at add_edge().");
+        return;
+    }
+    if (v == 0 || f == 0){
+        printf("map not found, invalid data. failed at add_edge().");
+        return;
+
+    }
+
+    //add_vertex does nothing for maps that are already vertices
+    add_vertex(g, v);
+    add_vertex(g, f);
+
+    int v_id = _index_get(&g -> index, v);
+    int f_id = _index_get(&g -> index, f);
+    if (v_id < 0 || f_id < 0){
+        return;
+    }
+
+    if (_edge_position(&g -> vertices[v_id], f_id) < 0){
+        _link_vertices(g, v_id, f_id, _label_id(&g -> labels, data, 1));
+    }
+
+    else{
+        printf("There is already an edge between the two vertices!\n");
+    }
+
+}
+
+void add_wedge(struct graph *g, struct map *v, char *data, struct map *f) {
+    _add_edge(g, v, f, data);
+}
+
+void add_edge(struct graph *g, struct map *v, struct map *f) {
+    _add_edge(g, v, f, EMPTY_STRING);
+}
+
+/*
+ * Adds n vertices and edges to g at once. Element i is the edge
+ * from[i] -> to[i] carrying data[i], or just the vertex from[i] if
+ * to[i] is NULL. The result is the same as making the add_wedge and
+ * add_vertex calls in order, but every edge array grows once, to its
+ * final size, and the duplicate checks go through the edge sets.
+ */
+void add_batch(struct graph *g, struct map **from, char **data, struct map **to, int n)
+{
+
+    if (g == 0){
+        printf("graph not found. failed at add_batch().");
+        return;
+    }
+
+    int *ids = malloc(2 * (n + 1) * sizeof(int));
+    if (ids == NULL){
+        printf("malloc failed at add_batch\n");
+        return;
+    }
+
+    //first resolve every map to its vertex, adding the new ones in order
+    int i;
+    for (i = 0; i < n; ++i){
+        ids[2 * i] = ids[2 * i + 1] = -1;
+        if (from[i] == 0){
+            printf("map not found, invalid data. failed at add_batch().");
+            continue;
+        }
+        add_vertex(g, from[i]);
+        ids[2 * i] = _index_get(&g -> index, from[i]);
+        if (to && to[i]){
+            add_vertex(g, to[i]);
+            ids[2 * i + 1] = _index_get(&g -> index, to[i]);
+        }
+    }
+
+    //then count the edges each vertex gains and grow its arrays once
+    int *out = calloc(g -> vertex_slots + 1, sizeof(int));
+    int *in = calloc(g -> vertex_slots + 1, sizeof(int));
+    if (out && in){
+        for (i = 0; i < n; ++i){
+            if (ids[2 * i] >= 0 && ids[2 * i + 1] >= 0){
+                ++out[ids[2 * i]];
+                ++in[ids[2 * i + 1]];
+            }
+        }
+        int id;
+        for (id = 0; id < g -> vertex_slots; ++id){
+            if (out[id]){
+                _reserve_edges(g, &g -> vertices[id], out[id]);
+            }
+            if (in[id]){
+                _reserve_in_edges(&g -> vertices[id], in[id]);
+            }
+        }
+    }
+    free(out);
+    free(in);
+
+    for (i = 0; i < n; ++i){
+        int a = ids[2 * i], b = ids[2 * i + 1];
+        if (a < 0 || b < 0){
+            continue;
+        }
+        if (_edge_position(&g -> vertices[a], b) < 0){
+            _link_vertices(g, a, b, data ? _label_id(&g -> labels, data[i], 1) : -1);
+        }
+        else{
+            printf("There is already an edge between the two vertices!\n");
+        }
+    }
+
+    free(ids);
+
+}
+/*
+ * deletes an edge between the two given vertices in graph g
+ */
+void delete_edge(struct graph *g, struct map *v, struct map *f)
+{
+
+    if (g == 0){
+        printf("Graph not found. delete_edge() failed.");
+        return;
+    }
+
+    if(v ==  0 || f == 0){
+        printf("Maps don't exist. delete_edge() failed.");
+        return;
+    }
+
+    int v_id = _index_get(&g -> index, v);
+    int f_id = _index_get(&g -> index, f);
+
+    //if either of the edges are in the graph then fail
+    if (v_id < 0 || f_id < 0){
+        printf("vertex not found. failed at add_edge()");
+        return;
+    }
+
+    int pos = _edge_position(&g -> vertices[v_id], f_id);
+    if (pos >= 0){
+        _unfreeze_graph(g);
+        _remove_edge_at(&g -> vertices[v_id], pos);
+        _remove_in_edge(&g -> vertices[f_id], v_id);
+        --(g -> edge_count);
+    }
+
+}
+
+int _find_edge(struct graph *g, struct map *v, struct map *f)
+{
+
+    if (g == 0){
+        printf("Graph not found. find_edge() failed.");
+        return 0;
+    }
+
+    if(v ==  0 || f == 0){
+        printf("Maps don't exist. find_edge() failed.");
+        return 0;
+    }
+
+    int v_id = _index_get(&g -> index, v);
+    int f_id = _index_get(&g -> index, f);
+
+    //if either of the vertex are in the graph then fail
+    if (v_id < 0 || f_id < 0){
+        printf("vertex not found. failed at find_edge()\n");
+        return 0;
+    }
+
+    return _edge_position(&g -> vertices[v_id], f_id) >= 0;
+
+}
+
+void _modify_edge(struct graph *g, struct map *v, struct map *f, char *data)
+{
+
+    if (g == 0){
+        printf("Graph not found. find_edge() failed.");
+        return ;
+    }
+
+    if(v ==  0 || f == 0){
+        printf("Maps don't exist. find_edge() failed.");
+        return ;
+    }
+
+    int v_id = _index_get(&g -> index, v);
+    int f_id = _index_get(&g -> index, f);
+
+    //if either of the edges are in the graph then fail
+    if (v_id < 0 || f_id < 0){
+        printf("vertex not found. failed at add_edge()");
+        return ;
+    }
+
+    int pos = _edge_position(&g -> vertices[v_id], f_id);
+    if (pos >= 0){
+        _unfreeze_graph(g);
+        g -> vertices[v_id].connected_edges[pos].label = _label_id(&g -> labels, data, 1);
+        _label_groups_free(&g -> vertices[v_id]);
+    }
+
+}
+
+/*
+ * Parallel helpers. Work is split into contiguous ranges, one per thread;
+ * below GRAPH_PARALLEL_THRESHOLD items it all runs on the calling thread.
+ */
+static int graph_threads = 1;
+
+void graph_set_threads(int n)
+{
+
+    graph_threads = n > 0 ? n : 1;
+
+}
+
+int graph_get_threads()
+{
+
+    return graph_threads;
+
+}
+
+struct _parallel_range {
+    void (*work)(void *ctx, int begin, int end);
+    void *ctx;
+    int begin;
+    int end;
+};
+
+static void * _parallel_run(void *arg)
+{
+
+    struct _parallel_range *r = arg;
+    r -> work(r -> ctx, r -> begin, r -> end);
+    return NULL;
+
+}
+
+/*
+ * How many threads to use for size units of work.
+ */
+static int _parallel_threads(long long size)
+{
+
+    long long threads = graph_threads;
+    if (threads > size / (GRAPH_PARALLEL_THRESHOLD / 4)){
+        threads = size / (GRAPH_PARALLEL_THRESHOLD / 4);
+    }
+    return size < GRAPH_PARALLEL_THRESHOLD || threads < 1 ? 1 : (int) threads;
+
+}
+
+/*
+ * Calls work(ctx, begin, end) over [0, n) cut at bounds[1 .. threads - 1],
+ * one range per thread. Runs serially if threads cannot be had.
+ */
+static void _parallel_ranges(int n, int *bounds, int threads, void (*work)(void *ctx, int begin, int end), void *ctx)
+{
+
+    pthread_t *tids = malloc(threads * sizeof(pthread_t));
+    struct _parallel_range *ranges = malloc(threads * sizeof(struct _parallel_range));
+    char *started = calloc(threads, 1);
+    if (tids == NULL || ranges == NULL || started == NULL){
+        free(tids);
+        free(ranges);
+        free(started);
+        work(ctx, 0, n);
+        return;
+    }
+
+    int t;
+    for (t = 0; t < threads; ++t){
+        ranges[t].work = work;
+        ranges[t].ctx = ctx;
+        ranges[t].begin = t == 0 ? 0 : bounds[t];
+        ranges[t].end = t == threads - 1 ? n : bounds[t + 1];
+    }
+
+    //the calling thread takes the first range itself
+    for (t = 1; t < threads; ++t){
+        started[t] = pthread_create(&tids[t], NULL, _parallel_run, &ranges[t]) == 0;
+    }
+    _parallel_run(&ranges[0]);
+    for (t = 1; t < threads; ++t){
+        if (started[t]){
+            pthread_join(tids[t], NULL);
+        }
+        else {
+            _parallel_run(&ranges[t]);
+        }
+    }
+
+    free(tids);
+    free(ranges);
+    free(started);
+
+}
+
+/*
+ * Calls work(ctx, begin, end) over ranges covering [0, n). Ranges never
+ * overlap, so work may write to per-item slots without locking.
+ */
+static void _parallel_for(int n, void (*work)(void *ctx, int begin, int end), void *ctx)
+{
+
+    int threads = _parallel_threads(n);
+    int *bounds = threads > 1 ? malloc((threads + 1) * sizeof(int)) : NULL;
+    if (bounds == NULL){
+        work(ctx, 0, n);
+        return;
+    }
+
+    int t;
+    for (t = 0; t <= threads; ++t){
+        bounds[t] = (int)((long long)n * t / threads);
+    }
+    _parallel_ranges(n, bounds, threads, work, ctx);
+    free(bounds);
+
+}
+
+/*
+ * Like _parallel_for, but items [0, i) weigh offsets[i] + i, and the
+ * ranges are cut so that each weighs about the same. With offsets
+ * counting edges, every thread gets about as many edges to walk.
+ */
+static void _parallel_for_weighted(int n, int *offsets, void (*work)(void *ctx, int begin, int end), void *ctx)
+{
+
+    long long total = (long long) offsets[n] + n;
+    int threads = _parallel_threads(total);
+    int *bounds = threads > 1 ? malloc((threads + 1) * sizeof(int)) : NULL;
+    if (bounds == NULL){
+        work(ctx, 0, n);
+        return;
+    }
+
+    //bounds[t] is the first item at or past t / threads of the weight
+    int t;
+    for (t = 0; t <= threads; ++t){
+        long long target = total * t / threads;
+        int lo = t > 0 ? bounds[t - 1] : 0, hi = n;
+        while (lo < hi){
+            int mid = lo + (hi - lo) / 2;
+            if ((long long) offsets[mid] + mid < target){
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        bounds[t] = lo;
+    }
+    _parallel_ranges(n, bounds, threads, work, ctx);
+    free(bounds);
+
+}
+
+/*
+ * Set operators. Each works in two passes: a read-only pass that matches
+ * the vertices and edges of one graph against the other through its hash
+ * index (the part that may run in parallel), and a serial pass that builds
+ * the result by appending to dense ids. Both are linear in V + E.
+ */
+
+/*
+ * What _copy_edges does with an edge, depending on whether the other
+ * graph has an edge between the same two vertices.
+ */
+#define COPY_ALL 0      //copy every edge
+#define COPY_SHARED 1   //copy only the edges the other graph has too
+#define COPY_NEW 2      //copy only the edges the other graph lacks
+#define COPY_OVERRIDE 3 //copy the edges the other graph lacks, overwrite the data of the rest
+
+struct _match_context {
+    struct graph *g;
+    struct graph *h;
+    int *match;
+    int *offsets;
+    char *shared;
+};
+
+/*
+ * match[id] = id in h of the map of g's vertex id, or -1.
+ */
+static void _match_vertex_range(void *arg, int begin, int end)
+{
+
+    struct _match_context *c = arg;
+    int id;
+    for (id = begin; id < end; ++id){
+        struct map *d = c -> g -> vertices[id].data;
+        c -> match[id] = d ? _index_get(&c -> h -> index, d) : -1;
+    }
+
+}
+
+/*
+ * shared[offsets[id] + i] = 1 if the i-th edge slot of g's vertex id is
+ * a live edge that h has too.
+ */
+static void _match_edge_range(void *arg, int begin, int end)
+{
+
+    struct _match_context *c = arg;
+    int id, i;
+    for (id = begin; id < end; ++id){
+        struct vertex *v = &c -> g -> vertices[id];
+        char *shared = c -> shared + c -> offsets[id];
+        int from = c -> match[id];
+        for (i = 0; i < v -> edge_slots; ++i){
+            int to = v -> connected_edges[i].to;
+            shared[i] = from >= 0 && to >= 0 && c -> match[to] >= 0
+                && _edge_position(&c -> h -> vertices[from], c -> match[to]) >= 0;
+        }
+    }
+
+}
+
+/*
+ * Matches g against h: fills match for every vertex id of g and, if
+ * offsets is given, shared for every edge slot of g.
+ */
+static void _match_graphs(struct graph *g, struct graph *h, int *match, int *offsets, char *shared)
+{
+
+    struct _match_context c = {g, h, match, offsets, shared};
+    _parallel_for(g -> vertex_slots, _match_vertex_range, &c);
+    if (offsets){
+        _parallel_for(g -> vertex_slots, _match_edge_range, &c);
+    }
+
+}
+
+/*
+ * offsets[id] = number of edge slots of the vertices of g before id.
+ * Returns NULL if memory ran out.
+ */
+static int * _edge_offsets(struct graph *g)
+{
+
+    int *offsets = malloc((g -> vertex_slots + 1) * sizeof(int));
+    if (offsets == NULL){
+        return NULL;
+    }
+
+    int id;
+    offsets[0] = 0;
+    for (id = 0; id < g -> vertex_slots; ++id){
+        offsets[id + 1] = offsets[id] + g -> vertices[id].edge_slots;
+    }
+    return offsets;
+
+}
+
+/*
+ * Copies the edges of g between vertices that ids maps into i, as
+ * decided by mode and the shared flags from _match_graphs.
+ */
+static void _copy_edges(struct graph *i, struct graph *g, int *ids, int *offsets, char *shared, int mode)
+{
+
+    int *labels = _translate_labels(i, g);
+    if (labels == NULL){
+        printf("malloc failed at copying edges\n");
+        return;
+    }
+
+    int id, k;
+    for (id = 0; id < g -> vertex_slots; ++id){
+        struct vertex *v = &g -> vertices[id];
+        if (v -> data == 0 || ids[id] < 0){
+            continue;
+        }
+        for (k = 0; k < v -> edge_slots; ++k){
+            struct edge *e = &v -> connected_edges[k];
+            if (e -> to < 0 || ids[e -> to] < 0){
+                continue;
+            }
+            int is_shared = shared && shared[offsets[id] + k];
+            int label = e -> label < 0 ? -1 : labels[e -> label];
+            if (mode == COPY_ALL || (mode == COPY_SHARED) == is_shared){
+                _link_vertices(i, ids[id], ids[e -> to], label);
+            }
+            else if (mode == COPY_OVERRIDE){
+                struct vertex *from = &i -> vertices[ids[id]];
+                int pos = _edge_position(from, ids[e -> to]);
+                if (pos >= 0){
+                    from -> connected_edges[pos].label = label;
+                    _label_groups_free(from);
+                }
+            }
+        }
+    }
+    free(labels);
+
+}
+
+/*
+ * Builds the union of g and h into a new graph: every vertex and every
+ * edge of either. Where both have an edge between the same two vertices
+ * the data of g's edge is kept, or of h's if h_wins.
+ */
+static struct graph * _merge_graphs(struct graph *g, struct graph *h, int h_wins)
+{
+
+    struct graph *i = new_graph();
+
+    int *g_ids = malloc((g -> vertex_slots + 1) * sizeof(int));
+    int *h_ids = malloc((h -> vertex_slots + 1) * sizeof(int));
+    int *match = malloc((h -> vertex_slots + 1) * sizeof(int));
+    int *offsets = _edge_offsets(h);
+    char *shared = offsets ? malloc(offsets[h -> vertex_slots] + 1) : NULL;
+    if (g_ids == NULL || h_ids == NULL || match == NULL || shared == NULL){
+        printf("malloc failed at merging graphs\n");
+    }
+    else {
+        //the vertices of g keep their order, then come the ones only h has
+        int id;
+        for (id = 0; id < g -> vertex_slots; ++id){
+            g_ids[id] = g -> vertices[id].data ? _insert_vertex(i, g -> vertices[id].data) : -1;
+        }
+
+        _match_graphs(h, g, match, offsets, shared);
+
+        for (id = 0; id < h -> vertex_slots; ++id){
+            if (h -> vertices[id].data == 0){
+                h_ids[id] = -1;
+            }
+            else if (match[id] >= 0){
+                h_ids[id] = g_ids[match[id]];
+            }
+            else {
+                h_ids[id] = _insert_vertex(i, h -> vertices[id].data);
+            }
+        }
+
+        _copy_edges(i, g, g_ids, NULL, NULL, COPY_ALL);
+        _copy_edges(i, h, h_ids, offsets, shared, h_wins ? COPY_OVERRIDE : COPY_NEW);
+    }
+
+    free(g_ids);
+    free(h_ids);
+    free(match);
+    free(offsets);
+    free(shared);
+    return i;
+
+}
+
+/*
+ * This will create a new graph that has the nodes that are in both
+ * g and h, and the edges between them that are in both. Edges keep
+ * the data they have in g.
+ */
+struct graph * intersection_graph(struct graph *g, struct graph *h)
+{
+
+    if (g == 0 || h == 0){
+        printf("Graph doesn't exist. intersection_graphs() failed.");
+        return 0;
+    }
+
+    struct graph *i = new_graph();
+
+    // if either graphs are empty, return the new empty graph
+    if (g -> vertex_count == 0 ||  h -> vertex_count == 0){
+        return i;
+    }
+
+    int *ids = malloc(g -> vertex_slots * sizeof(int));
+    int *match = malloc(g -> vertex_slots * sizeof(int));
+    int *offsets = _edge_offsets(g);
+    char *shared = offsets ? malloc(offsets[g -> vertex_slots] + 1) : NULL;
+    if (ids == NULL || match == NULL || shared == NULL){
+        printf("malloc failed at intersection_graph\n");
+    }
+    else {
+        _match_graphs(g, h, match, offsets, shared);
+
+        int id;
+        for (id = 0; id < g -> vertex_slots; ++id){
+            ids[id] = match[id] >= 0 ? _insert_vertex(i, g -> vertices[id].data) : -1;
+        }
+
+        _copy_edges(i, g, ids, offsets, shared, COPY_SHARED);
+    }
+
+    free(ids);
+    free(match);
+    free(offsets);
+    free(shared);
+    return i;
+}
+
+/*
+ * Union of two graphs, returns a new graph with all the nodes and edges
+ * in both graphs. Edges in both keep the data they have in g.
+ */
+struct graph * union_graph(struct graph *g, struct graph *h)
+{
+
+    if (g == 0 || h == 0){
+        printf("Graph doesn't exist. union_graphs() failed.");
+        return 0;
+    }
+
+    return _merge_graphs(g, h, 0);
+}
+
+/*
+ * Adds the two given graphs together and returns resulting graph.
+ * Like union, but h is laid over g: edges in both take h's data.
+ */
+struct graph * add (struct graph *g, struct graph *h){
+
+    if (g == 0 || h == 0){
+        printf("Graph doesn't exist. union_graphs() failed.");
+        return 0;
+    }
+
+    return _merge_graphs(g, h, 1);
+
+}
+
+/*
+ * A vertex id with the fingerprint of its map, for dedupe_vertices.
+ */
+struct fingerprint_id {
+
+    unsigned int fingerprint;
+    int id;
+
+};
+
+static int _compare_fingerprints(const void *a, const void *b)
+{
+
+    const struct fingerprint_id *x = a, *y = b;
+    if (x -> fingerprint != y -> fingerprint){
+        return x -> fingerprint < y -> fingerprint ? -1 : 1;
+    }
+    return x -> id - y -> id;
+
+}
+
+/*
+ * Merges every vertex of g into the first vertex with an equal map.
+ * Vertices are sorted by fingerprint, so maps are only compared within
+ * a run of equal fingerprints. Edges of a merged vertex move to the one
+ * it is merged into, unless that one already has them; an edge between
+ * two merged vertices becomes a loop. The maps of merged vertices are
+ * not freed.
+ * Returns how many vertices were removed.
+ */
+int dedupe_vertices(struct graph *g)
+{
+
+    if (g == 0){
+        printf("Graph doesn't exist. dedupe_vertices() failed.");
+        return 0;
+    }
+
+    struct fingerprint_id *order = malloc((g -> vertex_count + 1) * sizeof(struct fingerprint_id));
+    int *rep = malloc((g -> vertex_slots + 1) * sizeof(int));
+    if (order == NULL || rep == NULL){
+        printf("malloc failed at dedupe_vertices\n");
+        free(order);
+        free(rep);
+        return 0;
+    }
+
+    int id, n = 0;
+    for (id = 0; id < g -> vertex_slots; ++id){
+        rep[id] = id;
+        if (g -> vertices[id].data){
+            order[n].fingerprint = map_fingerprint(g -> vertices[id].data);
+            order[n].id = id;
+            ++n;
+        }
+    }
+    qsort(order, n, sizeof(struct fingerprint_id), _compare_fingerprints);
+
+    //within a run, each vertex joins the first earlier one it equals
+    int start, i, j;
+    for (start = 0; start < n; start = i){
+        for (i = start + 1; i < n && order[i].fingerprint == order[start].fingerprint; ++i){
+            struct map *m = g -> vertices[order[i].id].data;
+            for (j = start; j < i; ++j){
+                int r = order[j].id;
+                if (rep[r] == r && is_equal(g -> vertices[r].data, m)){
+                    rep[order[i].id] = r;
+                    break;
+                }
+            }
+        }
+    }
+    free(order);
+
+    int removed = 0;
+    for (id = 0; id < g -> vertex_slots; ++id){
+        int r = rep[id];
+        if (r == id){
+            continue;
+        }
+        struct vertex *v = &g -> vertices[id];
+
+        for (i = 0; i < v -> edge_slots; ++i){
+            struct edge *e = &v -> connected_edges[i];
+            int to = e -> to == id ? r : e -> to;
+            if (e -> to >= 0 && _edge_position(&g -> vertices[r], to) < 0){
+                _link_vertices(g, r, to, e -> label);
+            }
+        }
+        for (i = 0; i < v -> in_degree; ++i){
+            int from = v -> in_edges[i];
+            if (from == id){
+                continue;
+            }
+            struct vertex *source = &g -> vertices[from];
+            int pos = _edge_position(source, id);
+            if (pos >= 0 && _edge_position(source, r) < 0){
+                _link_vertices(g, from, r, source -> connected_edges[pos].label);
+            }
+        }
+
+        //the map may still be held by the program or another graph
+        _remove_vertex(g, id);
+        ++removed;
+    }
+
+    free(rep);
+    return removed;
+
+}
+
+/*
+ * Iterators. A cursor lives on the caller's stack and walks the adjacency
+ * or vertex storage in place, so nothing is allocated. Cursors see the
+ * same order as the lists below, and are invalidated by any change to g.
+ */
+
+/*
+ * Starts a cursor over the edges leaving data's vertex. The cursor is
+ * empty if data is not a vertex of g.
+ */
+void edge_iter_init(struct edge_iter *it, struct graph *g, struct map *data)
+{
+
+    int id = g ? get_vertex_id(g, data) : -1;
+
+    it -> g = g;
+    it -> neighbor = NULL;
+    it -> data = NULL;
+    if (id < 0){
+        it -> pos = 0;
+        it -> end = 0;
+    }
+    else if (g -> frozen){
+        it -> pos = g -> frozen -> offsets[id];
+        it -> end = g -> frozen -> offsets[id + 1];
+    }
+    else {
+        it -> pos = 0;
+        it -> end = g -> vertices[id].edge_slots;
+    }
+    it -> edges = id < 0 || g -> frozen ? NULL : g -> vertices[id].connected_edges;
+
+}
+
+/*
+ * Moves the cursor to the next edge, filling in its neighbor and data.
+ * Returns a 1 if there was one and 0 once the edges run out.
+ */
+int edge_iter_next(struct edge_iter *it)
+{
+
+    if (it -> edges == NULL){
+        if (it -> pos >= it -> end){
+            return 0;
+        }
+        struct csr_graph *c = it -> g -> frozen;
+        it -> neighbor = c -> vertex_data[c -> targets[it -> pos]];
+        it -> data = c -> edge_data[it -> pos];
+        ++(it -> pos);
+        return 1;
+    }
+
+    //step over the slots of deleted edges
+    while (it -> pos < it -> end){
+        struct edge *current = &it -> edges[(it -> pos)++];
+        if (current -> to >= 0){
+            it -> neighbor = it -> g -> vertices[current -> to].data;
+            it -> data = _edge_label(it -> g, current);
+            return 1;
+        }
+    }
+    return 0;
+
+}
+
+/*
+ * Starts a cursor over the vertices of g, in id order.
+ */
+void vertex_iter_init(struct vertex_iter *it, struct graph *g)
+{
+
+    it -> g = g;
+    it -> id = -1;
+    it -> data = NULL;
+
+}
+
+/*
+ * Moves the cursor to the next vertex, filling in its data.
+ * Returns a 1 if there was one and 0 once the vertices run out.
+ */
+int vertex_iter_next(struct vertex_iter *it)
+{
+
+    if (it -> g == 0){
+        return 0;
+    }
+    while (++(it -> id) < it -> g -> vertex_slots){
+        if (it -> g -> vertices[it -> id].data){
+            it -> data = it -> g -> vertices[it -> id].data;
+            return 1;
+        }
+    }
+    return 0;
+
+}
+
+/*
+ * Returns the slot of the i-th live edge of v, or -1. When v has no
+ * deleted slots this is i itself; otherwise the walk starts from the
+ * slot returned last, so reading the edges in order is O(1) each.
+ */
+static int _nth_edge_slot(struct vertex *v, int i)
+{
+
+    if (i < 0 || i >= v -> degree){
+        return -1;
+    }
+    if (v -> edge_slots == v -> degree){
+        return i;
+    }
+
+    //walk from the slot found last time when that is closer than the start
+    int k = -1, n = -1;
+    if (v -> nth_index >= 0 && (i >= v -> nth_index || v -> nth_index - i < i)){
+        k = v -> nth_slot;
+        n = v -> nth_index;
+    }
+    while (n < i){
+        if (v -> connected_edges[++k].to >= 0){
+            ++n;
+        }
+    }
+    while (n > i){
+        if (v -> connected_edges[--k].to >= 0){
+            --n;
+        }
+    }
+
+    v -> nth_index = i;
+    v -> nth_slot = k;
+    return k;
+
+}
+
+/*
+ * Returns how many edges leave data's vertex, i.e. the length of
+ * get_edge_neighbors(g, data), without building the list.
+ */
+int vertex_degree(struct graph *g, struct map *data)
+{
+
+    int id = g ? get_vertex_id(g, data) : -1;
+    return id < 0 ? 0 : g -> vertices[id].degree;
+
+}
+
+/*
+ * Returns how many vertices g has, i.e. the length of get_all_vertices(g).
+ */
+int vertex_total(struct graph *g)
+{
+
+    return g ? g -> vertex_count : 0;
+
+}
+
+/*
+ * Returns the i-th element of get_edge_neighbors(g, data) without
+ * building the list, or NULL if there is none.
+ */
+struct map * get_neighbor_at(struct graph *g, struct map *data, int i)
+{
+
+    int id = g ? get_vertex_id(g, data) : -1;
+    if (id < 0){
+        return NULL;
+    }
+    if (g -> frozen){
+        struct csr_graph *c = g -> frozen;
+        int k = c -> offsets[id] + i;
+        return i >= 0 && k < c -> offsets[id + 1] ? c -> vertex_data[c -> targets[k]] : NULL;
+    }
+
+    struct vertex *v = &g -> vertices[id];
+    int k = _nth_edge_slot(v, i);
+    return k < 0 ? NULL : g -> vertices[v -> connected_edges[k].to].data;
+
+}
+
+/*
+ * Returns the i-th element of _get_edges(g, data) without building the
+ * list, or NULL if there is none.
+ */
+char * get_edge_at(struct graph *g, struct map *data, int i)
+{
+
+    int id = g ? get_vertex_id(g, data) : -1;
+    if (id < 0){
+        return NULL;
+    }
+    if (g -> frozen){
+        struct csr_graph *c = g -> frozen;
+        int k = c -> offsets[id] + i;
+        return i >= 0 && k < c -> offsets[id + 1] ? c -> edge_data[k] : NULL;
+    }
+
+    struct vertex *v = &g -> vertices[id];
+    int k = _nth_edge_slot(v, i);
+    return k < 0 ? NULL : _edge_label(g, &v -> connected_edges[k]);
+
+}
+
+/*
+ * Returns the i-th element of get_all_vertices(g) without building the
+ * list, or NULL if there is none. When no vertex was ever deleted this
+ * is vertex id i.
+ */
+struct map * get_vertex_at(struct graph *g, int i)
+{
+
+    if (g == 0 || i < 0 || i >= g -> vertex_count){
+        return NULL;
+    }
+    if (g -> free_count == 0){
+        return g -> vertices[i].data;
+    }
+
+    struct vertex_iter it;
+    vertex_iter_init(&it, g);
+    while (vertex_iter_next(&it)){
+        if (i-- == 0){
+            return it.data;
+        }
+    }
+    return NULL;
+
+}
+
+/*
+ * Given a graph and a node, return all the edges given that node.
+ */
+struct list *_get_edges(struct graph *g, struct map *data){
+
+    if (g == 0){
+        printf("Graph doesn't exist. union_graphs() failed.");
+        return 0;
+    }
+
+    if (data == 0){
+        printf("Data doesn't exist. get_edges() failed.");
+    }
+
+    struct list *edges_queue = make_list();
+
+    struct edge_iter it;
+    for (edge_iter_init(&it, g, data); edge_iter_next(&it); ){
+        add_tail(edges_queue, it.data);
+    }
+    return edges_queue;
+}
+
+/*
+ * Given a graph and a node, return the list of vertices that the vertex given connected to.
+ */
+struct list *get_edge_neighbors(struct graph *g, struct map *data){
+
+    if (g == 0){
+        printf("Graph doesn't exist. union_graphs() failed.");
+        return 0;
+    }
+    if (data == 0){
+        printf("Data doesn't exist. get_edges() failed.");
+    }
+
+    struct list *edges_queue = make_list();
+
+    struct edge_iter it;
+    for (edge_iter_init(&it, g, data); edge_iter_next(&it); ){
+        add_tail(edges_queue, it.neighbor);
+    }
+    return edges_queue;
+
+}
+
+/*
+ * Given a graph and a node, return the list of vertices with an edge to it.
+ */
+struct list *get_in_neighbors(struct graph *g, struct map *data){
+
+    if (g == 0){
+        printf("Graph doesn't exist. get_in_neighbors() failed.");
+        return 0;
+    }
+    if (data == 0){
+        printf("Data doesn't exist. get_in_neighbors() failed.");
+    }
+
+    struct list *in_queue = make_list();
+
+    int id = get_vertex_id(g, data);
+    if (id < 0){
+        return in_queue;
+    }
+
+    struct vertex *current_vertex = &g -> vertices[id];
+    int i;
+    for (i = 0; i < current_vertex -> in_degree; ++i){
+        add_tail(in_queue, g -> vertices[current_vertex -> in_edges[i]].data);
+    }
+    return in_queue;
+
+}
+
+/*
+ * Given a graph, a node and a label, return the vertices the node has an
+ * edge to with that label. Small vertices compare label ids edge by edge;
+ * larger ones look the label up in their label groups.
+ */
+struct list *get_neighbors_by_label(struct graph *g, struct map *data, char *label){
+
+    if (g == 0){
+        printf("Graph doesn't exist. get_neighbors_by_label() failed.");
+        return 0;
+    }
+    if (data == 0){
+        printf("Data doesn't exist. get_neighbors_by_label() failed.");
+    }
+
+    struct list *neighbors = make_list();
+
+    int id = get_vertex_id(g, data);
+    int l = _label_id(&g -> labels, label, 0);
+    if (id < 0 || l < 0){
+        return neighbors;
+    }
+
+    struct vertex *v = &g -> vertices[id];
+    if (v -> degree > EDGE_SET_THRESHOLD && v -> groups == NULL){
+        v -> groups = _label_groups_build(v);
+    }
+
+    int i;
+    if (v -> groups == NULL){
+        for (i = 0; i < v -> edge_slots; ++i){
+            struct edge *e = &v -> connected_edges[i];
+            if (e -> to >= 0 && e -> label == l){
+                add_tail(neighbors, g -> vertices[e -> to].data);
             }
         }
-	else {
-            add_vertex(g,a);
+        return neighbors;
+    }
+
+    struct label_groups *groups = v -> groups;
+    int lo = 0, hi = groups -> count;
+    while (lo < hi){
+        int mid = (lo + hi) / 2;
+        if (groups -> labels[mid] < l){
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    if (lo < groups -> count && groups -> labels[lo] == l){
+        for (i = groups -> offsets[lo]; i < groups -> offsets[lo + 1]; ++i){
+            add_tail(neighbors, g -> vertices[v -> connected_edges[groups -> positions[i]].to].data);
+        }
+    }
+    return neighbors;
+
+}
+
+/*
+ * Starts keeping an index of g's vertices by their value for key.
+ * Does nothing if there is one already.
+ */
+void index_attribute(struct graph *g, char *key){
+
+    if (g == 0 || key == 0){
+        printf("Graph or key doesn't exist. index_attribute() failed.");
+        return;
+    }
+
+    struct attr_index *idx;
+    for (idx = g -> attr_indexes; idx; idx = idx -> next){
+        if (strcmp(idx -> key, key) == 0){
+            return;
+        }
+    }
+
+    idx = malloc(sizeof(struct attr_index));
+    if (idx == NULL){
+        printf("malloc failed at index_attribute()\n");
+        return;
+    }
+    idx -> key = key;
+    idx -> buckets = NULL;
+    idx -> size = 0;
+    idx -> capacity = 0;
+    idx -> id_buckets = NULL;
+    idx -> id_positions = NULL;
+    idx -> id_capacity = 0;
+    idx -> next = g -> attr_indexes;
+    g -> attr_indexes = idx;
+
+    int id;
+    for (id = 0; id < g -> vertex_slots; ++id){
+        if (g -> vertices[id].data){
+            _attr_index_add(idx, id, g -> vertices[id].data);
+        }
+    }
+
+}
+
+/*
+ * Returns the vertices of g whose map has value under key, in id order.
+ * With an index on key only the matching vertices are visited; without
+ * one every vertex is, reading key's column if the column store has
+ * one, and a note saying so goes to stderr.
+ */
+struct list *find_vertices(struct graph *g, char *key, char *value){
+
+    if (g == 0){
+        printf("Graph doesn't exist. find_vertices() failed.");
+        return 0;
+    }
+
+    struct list *found = make_list();
+    if (key == 0 || value == 0){
+        return found;
+    }
+
+    struct attr_index *idx;
+    for (idx = g -> attr_indexes; idx; idx = idx -> next){
+        if (strcmp(idx -> key, key) == 0){
+            break;
+        }
+    }
+
+    int id;
+    char **column = idx ? NULL : get_attribute_column(g, key);
+    if (column){
+        fprintf(stderr, "No index on \"%s\": find_vertices() scanned its column.\n", key);
+        //rows whose map changed since the snapshot are read from the map
+        for (id = 0; id < g -> vertex_slots; ++id){
+            struct map *m = g -> vertices[id].data;
+            char *v = column[id];
+            if (m && map_fingerprint(m) != g -> columns -> fingerprints[id]){
+                v = map_get(m, key);
+            }
+            if (m && v && (v == value || strcmp(v, value) == 0)){
+                add_tail(found, m);
+            }
+        }
+        return found;
+    }
+    if (idx == NULL){
+        fprintf(stderr, "No index on \"%s\": find_vertices() scanned the graph.\n", key);
+        for (id = 0; id < g -> vertex_slots; ++id){
+            struct map *m = g -> vertices[id].data;
+            char *v = m ? map_get(m, key) : 0;
+            if (v && strcmp(v, value) == 0){
+                add_tail(found, m);
+            }
+        }
+        return found;
+    }
+
+    if (idx -> capacity == 0){
+        return found;
+    }
+    struct attr_bucket *b = &idx -> buckets[_attr_bucket_slot(idx, value, _hash_string(value))];
+    if (b -> value == 0 || b -> count == 0){
+        return found;
+    }
+
+    int *ids = malloc(b -> count * sizeof(int));
+    if (ids == NULL){
+        printf("malloc failed at find_vertices()\n");
+        return found;
+    }
+    memcpy(ids, b -> ids, b -> count * sizeof(int));
+    qsort(ids, b -> count, sizeof(int), _compare_ids);
+
+    //skip vertices whose value has since been changed in place
+    int i;
+    for (i = 0; i < b -> count; ++i){
+        struct map *m = g -> vertices[ids[i]].data;
+        char *v = m ? map_get(m, key) : 0;
+        if (v && strcmp(v, value) == 0){
+            add_tail(found, m);
+        }
+    }
+    free(ids);
+    return found;
+
+}
+
+/*
+ * Builds g's attribute column store, or returns the one it has.
+ * Keys are counted first; those held by at least half of the vertices
+ * become columns, filled in one more pass over the vertex maps.
+ */
+struct attr_columns * columnize_graph(struct graph *g){
+
+    if (g == 0){
+        printf("Graph doesn't exist. columnize_graph() failed.");
+        return 0;
+    }
+    if (g -> columns){
+        return g -> columns;
+    }
+
+    struct label_dict keys;
+    _label_dict_init(&keys);
+    int *counts = NULL, counts_capacity = 0;
+
+    int id, i;
+    for (id = 0; id < g -> vertex_slots; ++id){
+        struct map *m = g -> vertices[id].data;
+        for (i = 0; m && i < m -> used; ++i){
+            if (m -> nodes[i].key == 0){
+                continue;
+            }
+            int k = _label_id(&keys, m -> nodes[i].key, 1);
+            if (k < 0){
+                continue;
+            }
+            if (k >= counts_capacity){
+                int capacity = counts_capacity ? 2 * counts_capacity : LABEL_MIN_CAPACITY;
+                int *grown = realloc(counts, capacity * sizeof(int));
+                if (grown == NULL){
+                    continue;
+                }
+                memset(grown + counts_capacity, 0, (capacity - counts_capacity) * sizeof(int));
+                counts = grown;
+                counts_capacity = capacity;
+            }
+            ++counts[k];
+        }
+    }
+
+    //column[k] is the column of key k, or -1 if it stays in the maps
+    struct attr_columns *c = malloc(sizeof(struct attr_columns));
+    int *column = malloc((keys.count + 1) * sizeof(int));
+    if (c){
+        c -> columns = malloc((keys.count + 1) * sizeof(struct attr_column));
+        c -> fingerprints = malloc((g -> vertex_slots + 1) * sizeof(unsigned int));
+    }
+    if (c == NULL || column == NULL || c -> columns == NULL || c -> fingerprints == NULL){
+        printf("malloc failed at columnize_graph()\n");
+        if (c){
+            free(c -> columns);
+            free(c -> fingerprints);
+        }
+        free(c);
+        free(column);
+        free(counts);
+        _label_dict_free(&keys);
+        return 0;
+    }
+
+    c -> vertex_slots = g -> vertex_slots;
+    c -> count = 0;
+    for (i = 0; i < keys.count; ++i){
+        column[i] = -1;
+        if (2 * counts[i] < g -> vertex_count){
+            continue;
+        }
+        char **values = calloc(g -> vertex_slots + 1, sizeof(char *));
+        if (values == NULL){
+            continue;
+        }
+        column[i] = c -> count;
+        c -> columns[c -> count].key = keys.names[i];
+        c -> columns[(c -> count)++].values = values;
+    }
+
+    for (id = 0; id < g -> vertex_slots; ++id){
+        struct map *m = g -> vertices[id].data;
+        c -> fingerprints[id] = m ? map_fingerprint(m) : 0;
+        for (i = 0; m && i < m -> used; ++i){
+            if (m -> nodes[i].key == 0){
+                continue;
+            }
+            int k = _label_id(&keys, m -> nodes[i].key, 0);
+            if (k >= 0 && column[k] >= 0){
+                c -> columns[column[k]].values[id] = m -> nodes[i].value;
+            }
         }
     }
-    else{
-        if(b){
-	    delete_edge(g,a,b);
+
+    free(column);
+    free(counts);
+    _label_dict_free(&keys);
+    g -> columns = c;
+    return c;
+
+}
+
+/*
+ * Returns the column of key in g's attribute store, indexed by vertex
+ * id, or NULL if there is none.
+ */
+char **get_attribute_column(struct graph *g, char *key){
+
+    if (g == 0 || g -> columns == 0 || key == 0){
+        return 0;
+    }
+    int k;
+    for (k = 0; k < g -> columns -> count; ++k){
+        if (strcmp(g -> columns -> columns[k].key, key) == 0){
+            return g -> columns -> columns[k].values;
         }
-	else{
-            delete_vertex(g,a);
+    }
+    return 0;
+
+}
+
+struct list *get_all_vertices(struct graph *g){
+
+    struct list *all_vertices = make_list();
+
+    struct vertex_iter it;
+    for (vertex_iter_init(&it, g); vertex_iter_next(&it); ){
+        add_tail(all_vertices, it.data);
+    }
+
+    return all_vertices;
+
+}
+
+/*
+ * prints out all the edges and nodes of a graph
+ */
+void printg(struct graph *g){
+
+    int id;
+    for (id = 0; id < g -> vertex_slots; ++id){
+        struct map *tmp = g -> vertices[id].data;
+        if (tmp == 0){
+            continue;
         }
+
+        printf("%s", "vertex data:\n");
+        print_vertex(tmp);
+
+
+        _print_edge(g, &g -> vertices[id]);
+
+        printf("\n");
+
     }
+
 }
 
-void add_vertex(struct graph *g, struct map *data){
+void print_vertex(struct map *m){
 
-	if(g == 0){
-		printf("graph not found! add_new_vertex()\n");
-        return ;
+	int printed = 0;
+	int i;
+	for (i = m->used - 1; i >= 0; --i) {
+		struct map_node *current = &m->nodes[i];
+		if (current->key == NULL)
+			continue;
+
+		printf("\"%s\" : \"%s\"", current->key, current->value);
+		if (++printed < m->size)
+			printf(" , ");
+		else
+			printf("\n");
 	}
 
-	if (data == 0){
-        printf("vertex not found! add_new_vertex()\n");
-        return ;
+}
+
+void _print_edge(struct graph *g, struct vertex *v){
+
+    int i;
+    for (i = 0; i < v -> edge_slots; ++i){
+        struct edge *e = &v -> connected_edges[i];
+        if (e -> to < 0){
+            continue;
+        }
+        printf("%s: %s\n", "Edge data", _edge_label(g, e));
+        printf("Connected to: ");
+        print_vertex(g -> vertices[e -> to].data);
+    }
+}
+
+
+/*
+ * Frozen graphs.
+ */
+
+/*
+ * Returns a compressed sparse row snapshot of g, building it on first use.
+ * The snapshot belongs to g and stays valid until g is next modified.
+ */
+struct csr_graph * freeze_graph(struct graph *g)
+{
+
+    if (g == 0){
+        printf("Graph doesn't exist. freeze_graph() failed.");
+        return 0;
     }
 
-	//create a new vertex with the data
-	struct vertex *v = _new_vertex(data);
+    if (g -> frozen){
+        return g -> frozen;
+    }
 
-	++(g -> vertex_count);
+    struct csr_graph *c = malloc(sizeof(struct csr_graph));
+    if (c == 0){
+        printf("malloc failed at freeze_graph()\n");
+        return 0;
+    }
 
-	//traverse list until end, then add new node to the end
-	struct vertex *current = g -> vertex_head;
+    int n = g -> vertex_slots;
+    c -> vertex_slots = n;
+    c -> edge_count = g -> edge_count;
+    c -> offsets = malloc((n + 1) * sizeof(int));
+    c -> targets = malloc((g -> edge_count + 1) * sizeof(int));
+    c -> edge_data = malloc((g -> edge_count + 1) * sizeof(char *));
+    c -> vertex_data = malloc((n + 1) * sizeof(struct map *));
+    if (c -> offsets == 0 || c -> targets == 0 || c -> edge_data == 0 || c -> vertex_data == 0){
+        printf("malloc failed at freeze_graph()\n");
+        g -> frozen = c;
+        _unfreeze_graph(g);
+        return 0;
+    }
 
-    //if we have no verices yet, then add the first vertex to the list
-    if (g -> vertex_head == 0){
-        g -> vertex_head = v;
-        return;
+    //rows follow vertex ids, so ids and side arrays stay interchangeable
+    int id, i, e = 0;
+    for (id = 0; id < n; ++id){
+        struct vertex *v = &g -> vertices[id];
+        c -> offsets[id] = e;
+        c -> vertex_data[id] = v -> data;
+        if (v -> data == 0){
+            continue;
+        }
+        for (i = 0; i < v -> edge_slots; ++i){
+            if (v -> connected_edges[i].to >= 0){
+                c -> targets[e] = v -> connected_edges[i].to;
+                c -> edge_data[e] = _edge_label(g, &v -> connected_edges[i]);
+                ++e;
+            }
+        }
     }
+    c -> offsets[n] = e;
 
-    //otherwise traverse until we can't and then add
-	while(current -> next_vertex){
-		current = current -> next_vertex;
-	}
+    g -> frozen = c;
+    return c;
 
-	current -> next_vertex = v;
-	return ;
 }
 
-void delete_vertex(struct graph *g, struct map *data)
+
+/*
+ * Graph clean up functions.
+ */
+
+/*
+ * Traversals. They work on vertex ids, marking visited vertices in a
+ * bitset, and read the frozen snapshot when g has one.
+ */
+
+#define BITSET_WORDS(n) (((n) + 63) / 64)
+#define BITSET_TEST(b, i) (((b)[(i) >> 6] >> ((i) & 63)) & 1)
+#define BITSET_SET(b, i) ((b)[(i) >> 6] |= 1ULL << ((i) & 63))
+
+/*
+ * The first edge position of vertex id, for _next_neighbor.
+ */
+static int _first_edge(struct graph *g, int id)
 {
 
-	if(g == 0){
-        printf("graph not found: delete_vertex()!\n");
-        return;
+    return g -> frozen ? g -> frozen -> offsets[id] : 0;
+
+}
+
+/*
+ * Returns the neighbor of vertex id at the first live edge from *pos
+ * on and moves *pos past it, or returns -1 once the edges run out.
+ */
+static int _next_neighbor(struct graph *g, int id, int *pos)
+{
+
+    if (g -> frozen){
+        return *pos < g -> frozen -> offsets[id + 1] ? g -> frozen -> targets[(*pos)++] : -1;
     }
-    if(g -> vertex_count == 0){
-        printf("no vertex to delete in: delete_vertex()\n");
-        return;
+
+    struct vertex *v = &g -> vertices[id];
+    while (*pos < v -> edge_slots){
+        int to = v -> connected_edges[(*pos)++].to;
+        if (to >= 0){
+            return to;
+        }
     }
+    return -1;
 
-	//get the vertex to be deleted
-	struct vertex *to_delete = get_vertex(g, data);
-	struct vertex * prev; //used to fix vertices list in graphs later
+}
 
-	if(!to_delete){
-		printf("vertex not found\n");
-		return;
-	}
+/*
+ * Allocates a traversal of g with nothing reached, along with a
+ * cleared visited bitset. Returns NULL if memory ran out.
+ */
+static struct traversal * _new_traversal(struct graph *g, unsigned long long **visited)
+{
 
-	//traverse and try to find the node needed to delete
-	struct vertex *current = g -> vertex_head;
+    int n = g -> vertex_slots;
+    struct traversal *t = malloc(sizeof(struct traversal));
+    *visited = calloc(BITSET_WORDS(n) + 1, sizeof(unsigned long long));
+    if (t){
+        t -> order = malloc((n + 1) * sizeof(int));
+        t -> depth = malloc((n + 1) * sizeof(int));
+        t -> parent = malloc((n + 1) * sizeof(int));
+    }
+    if (t == NULL || *visited == NULL || t -> order == NULL || t -> depth == NULL || t -> parent == NULL){
+        printf("malloc failed at traversing the graph\n");
+        free(*visited);
+        free_traversal(t);
+        return NULL;
+    }
 
-	//accounts for if the deleted node is the head of the vertex
-	if((g -> vertex_head) == to_delete){
-        struct vertex *tmp = (g -> vertex_head) -> next_vertex;
-		g -> vertex_head = tmp;
-	}
+    t -> vertex_slots = n;
+    t -> count = 0;
+    memset(t -> depth, -1, n * sizeof(int));
+    memset(t -> parent, -1, n * sizeof(int));
+    return t;
 
-	//otherwise traverse the list until we see the delete node as our next node
-	else {
-		while (current -> next_vertex){
-			/*if we found the node that we are looking for, make current skip its next node and point to the node after*/
-			//how do we compare these two?
-			if (current -> next_vertex == to_delete){
-			    struct vertex *tmp = current -> next_vertex;
-				struct vertex *next_node = tmp -> next_vertex;
-				current -> next_vertex = next_node;
-				break;
-			}
+}
 
-			current = current -> next_vertex;
-		}
-	}
+void free_traversal(struct traversal *t)
+{
+
+    if (t){
+        free(t -> order);
+        free(t -> depth);
+        free(t -> parent);
+        free(t);
+    }
+
+}
 
-	//go through the list and delete the nodes from each edge list
-	//remove like how we did above where we just redirect the next pointer
-    struct vertex *current2 = g -> vertex_head;
+/*
+ * Breadth-first search from src. Every vertex enters the queue once,
+ * so the visit order itself serves as the queue.
+ */
+struct traversal * bfs(struct graph *g, struct map *src)
+{
+
+    int s = g ? get_vertex_id(g, src) : -1;
+    if (s < 0){
+        printf("vertex not found! bfs()\n");
+        return NULL;
+    }
 
-    while(current2){
+    unsigned long long *visited;
+    struct traversal *t = _new_traversal(g, &visited);
+    if (t == NULL){
+        return NULL;
+    }
 
-        struct edge *current_edge = current2 -> connected_edges;
-        if(current_edge != 0){
-            if (current_edge -> to == to_delete){
-                struct edge *tmp = current_edge -> next;
-                current_edge = tmp;
+    BITSET_SET(visited, s);
+    t -> depth[s] = 0;
+    t -> order[(t -> count)++] = s;
+
+    int head;
+    for (head = 0; head < t -> count; ++head){
+        int id = t -> order[head];
+        int pos = _first_edge(g, id), to;
+        while ((to = _next_neighbor(g, id, &pos)) >= 0){
+            if (!BITSET_TEST(visited, to)){
+                BITSET_SET(visited, to);
+                t -> depth[to] = t -> depth[id] + 1;
+                t -> parent[to] = id;
+                t -> order[(t -> count)++] = to;
             }
-            else{
-                while (current_edge -> next){
-                    struct edge *tmp = current_edge -> next;
-                    if(tmp -> from  == to_delete){
-                        current_edge -> next = tmp -> next;
-                        _free_edge(tmp);
-                    }
+        }
+    }
 
-                    current_edge = current_edge -> next;
+    free(visited);
+    return t;
 
-                }
+}
+
+/*
+ * Depth-first search from src, in preorder. The stack holds the path
+ * from src with the next edge position to try at each vertex, so no
+ * recursion is needed.
+ */
+struct traversal * dfs(struct graph *g, struct map *src)
+{
+
+    int s = g ? get_vertex_id(g, src) : -1;
+    if (s < 0){
+        printf("vertex not found! dfs()\n");
+        return NULL;
+    }
+
+    unsigned long long *visited;
+    struct traversal *t = _new_traversal(g, &visited);
+    int *stack = malloc((g -> vertex_slots + 1) * sizeof(int));
+    int *next = malloc((g -> vertex_slots + 1) * sizeof(int));
+    if (t == NULL || stack == NULL || next == NULL){
+        if (t){
+            printf("malloc failed at traversing the graph\n");
+            free(visited);
+            free_traversal(t);
+        }
+        free(stack);
+        free(next);
+        return NULL;
+    }
+
+    BITSET_SET(visited, s);
+    t -> depth[s] = 0;
+    t -> order[(t -> count)++] = s;
+    next[s] = _first_edge(g, s);
+
+    int top = 0;
+    stack[0] = s;
+    while (top >= 0){
+        int id = stack[top];
+        int to = _next_neighbor(g, id, &next[id]);
+        if (to < 0){
+            --top;
+        }
+        else if (!BITSET_TEST(visited, to)){
+            BITSET_SET(visited, to);
+            t -> depth[to] = top + 1;
+            t -> parent[to] = id;
+            t -> order[(t -> count)++] = to;
+            next[to] = _first_edge(g, to);
+            stack[++top] = to;
+        }
+    }
+
+    free(stack);
+    free(next);
+    free(visited);
+    return t;
+
+}
+
+#define TRAVERSAL_ORDER 0
+#define TRAVERSAL_DEPTHS 1
+#define TRAVERSAL_PARENTS 2
+
+/*
+ * Lists the vertices of t in visit order, or their depths or parents
+ * as what says, and frees t.
+ */
+static struct list * _traversal_list(struct graph *g, struct traversal *t, int what)
+{
+
+    struct list *l = make_list();
+    if (t == NULL){
+        return l;
+    }
+
+    int i;
+    for (i = 0; i < t -> count; ++i){
+        int id = t -> order[i];
+        if (what == TRAVERSAL_DEPTHS){
+            add_tail_int(l, t -> depth[id]);
+        }
+        else {
+            int p = what == TRAVERSAL_PARENTS && t -> parent[id] >= 0 ? t -> parent[id] : id;
+            add_tail(l, g -> vertices[p].data);
+        }
+    }
+    free_traversal(t);
+    return l;
+
+}
+
+struct list * bfs_order(struct graph *g, struct map *src)
+{
+
+    return _traversal_list(g, bfs(g, src), TRAVERSAL_ORDER);
+
+}
+
+struct list * dfs_order(struct graph *g, struct map *src)
+{
+
+    return _traversal_list(g, dfs(g, src), TRAVERSAL_ORDER);
+
+}
+
+struct list * bfs_depths(struct graph *g, struct map *src)
+{
+
+    return _traversal_list(g, bfs(g, src), TRAVERSAL_DEPTHS);
+
+}
+
+struct list * bfs_parents(struct graph *g, struct map *src)
+{
+
+    return _traversal_list(g, bfs(g, src), TRAVERSAL_PARENTS);
+
+}
+
+/*
+ * Parallel BFS, level by level. The frontier of each level is a slice
+ * of the visit order, and the next one is appended right after it.
+ * Top-down steps split the frontier among threads, which claim new
+ * vertices with an atomic or on the visited bitset and collect them
+ * in a buffer of their own before copying them into the order. Bottom-up
+ * steps split the vertices instead: each unvisited vertex looks for
+ * an in-neighbor in the frontier, kept as a bitset for that level.
+ */
+
+#define BFS_BUFFER 1024
+#define BFS_ALPHA 14 //go bottom-up when the frontier has this share of the unexplored edges
+#define BFS_BETA 24  //go top-down again when the frontier has fewer than 1/BETA of the vertices
+
+struct _bfs_context {
+    struct graph *g;
+    struct csr_graph *c;
+    struct traversal *t;
+    unsigned long long *visited;
+    unsigned long long *frontier;
+    int begin;          //the frontier is t -> order[begin .. end)
+    int end;
+    int next;           //where the next level is being appended
+    long long next_edges;
+    int level;
+};
+
+/*
+ * Vertices found by one thread in one step, flushed into the order
+ * when full and at the end of the step.
+ */
+struct _bfs_buffer {
+    int ids[BFS_BUFFER];
+    int count;
+    long long edges;
+};
+
+static void _bfs_flush(struct _bfs_context *c, struct _bfs_buffer *b)
+{
+
+    int at = __atomic_fetch_add(&c -> next, b -> count, __ATOMIC_RELAXED);
+    memcpy(c -> t -> order + at, b -> ids, b -> count * sizeof(int));
+    __atomic_fetch_add(&c -> next_edges, b -> edges, __ATOMIC_RELAXED);
+    b -> count = 0;
+    b -> edges = 0;
+
+}
+
+/*
+ * Records that vertex to was reached from u at the next level.
+ */
+static void _bfs_found(struct _bfs_context *c, struct _bfs_buffer *b, int u, int to)
+{
+
+    c -> t -> parent[to] = u;
+    c -> t -> depth[to] = c -> level + 1;
+    b -> ids[(b -> count)++] = to;
+    b -> edges += c -> c -> offsets[to + 1] - c -> c -> offsets[to];
+    if (b -> count == BFS_BUFFER){
+        _bfs_flush(c, b);
+    }
+
+}
+
+static void _bfs_top_down(void *arg, int begin, int end)
+{
+
+    struct _bfs_context *c = arg;
+    struct _bfs_buffer b;
+    b.count = 0;
+    b.edges = 0;
+
+    int i, e;
+    for (i = c -> begin + begin; i < c -> begin + end; ++i){
+        int u = c -> t -> order[i];
+        for (e = c -> c -> offsets[u]; e < c -> c -> offsets[u + 1]; ++e){
+            int to = c -> c -> targets[e];
+            unsigned long long bit = 1ULL << (to & 63);
+            if (__atomic_load_n(&c -> visited[to >> 6], __ATOMIC_RELAXED) & bit){
+                continue;
+            }
+            if (!(__atomic_fetch_or(&c -> visited[to >> 6], bit, __ATOMIC_RELAXED) & bit)){
+                _bfs_found(c, &b, u, to);
             }
         }
+    }
+    _bfs_flush(c, &b);
+
+}
+
+static void _bfs_bottom_up(void *arg, int begin, int end)
+{
+
+    struct _bfs_context *c = arg;
+    struct _bfs_buffer b;
+    b.count = 0;
+    b.edges = 0;
+
+    int v, i;
+    for (v = begin; v < end; ++v){
+        unsigned long long bit = 1ULL << (v & 63);
+        if (c -> c -> vertex_data[v] == 0 || (__atomic_load_n(&c -> visited[v >> 6], __ATOMIC_RELAXED) & bit)){
+            continue;
+        }
+        struct vertex *x = &c -> g -> vertices[v];
+        for (i = 0; i < x -> in_degree; ++i){
+            int u = x -> in_edges[i];
+            if (BITSET_TEST(c -> frontier, u)){
+                __atomic_fetch_or(&c -> visited[v >> 6], bit, __ATOMIC_RELAXED);
+                _bfs_found(c, &b, u, v);
+                break;
+            }
+        }
+    }
+    _bfs_flush(c, &b);
+
+}
+
+static void _bfs_mark_frontier(void *arg, int begin, int end)
+{
+
+    struct _bfs_context *c = arg;
+    int i;
+    for (i = c -> begin + begin; i < c -> begin + end; ++i){
+        int u = c -> t -> order[i];
+        __atomic_fetch_or(&c -> frontier[u >> 6], 1ULL << (u & 63), __ATOMIC_RELAXED);
+    }
+
+}
+
+struct traversal * parallel_bfs(struct graph *g, struct map *src)
+{
+
+    int s = g ? get_vertex_id(g, src) : -1;
+    if (s < 0){
+        printf("vertex not found! parallel_bfs()\n");
+        return NULL;
+    }
+
+    struct _bfs_context c;
+    c.g = g;
+    c.c = freeze_graph(g);
+    if (c.c == NULL){
+        return NULL;
+    }
+    int n = g -> vertex_slots;
+    c.t = _new_traversal(g, &c.visited);
+    c.frontier = malloc((BITSET_WORDS(n) + 1) * sizeof(unsigned long long));
+    if (c.t == NULL || c.frontier == NULL){
+        if (c.t){
+            printf("malloc failed at traversing the graph\n");
+            free(c.visited);
+            free_traversal(c.t);
+        }
+        free(c.frontier);
+        return NULL;
+    }
+
+    BITSET_SET(c.visited, s);
+    c.t -> depth[s] = 0;
+    c.t -> order[0] = s;
+    c.begin = 0;
+    c.end = 1;
+    c.level = 0;
+
+    long long frontier_edges = c.c -> offsets[s + 1] - c.c -> offsets[s];
+    long long unexplored = c.c -> edge_count - frontier_edges;
+    int bottom_up = 0;
+    while (c.begin < c.end){
+        int size = c.end - c.begin;
+        if (!bottom_up && frontier_edges > unexplored / BFS_ALPHA){
+            bottom_up = 1;
+        }
+        else if (bottom_up && size < n / BFS_BETA){
+            bottom_up = 0;
+        }
 
+        c.next = c.end;
+        c.next_edges = 0;
+        if (bottom_up){
+            memset(c.frontier, 0, BITSET_WORDS(n) * sizeof(unsigned long long));
+            _parallel_for(size, _bfs_mark_frontier, &c);
+            _parallel_for(n, _bfs_bottom_up, &c);
+        }
+        else {
+            _parallel_for(size, _bfs_top_down, &c);
+        }
 
-        current2 = current2 -> next_vertex;
+        frontier_edges = c.next_edges;
+        unexplored -= frontier_edges;
+        c.begin = c.end;
+        c.end = c.next;
+        ++(c.level);
     }
+    c.t -> count = c.end;
 
-    _free_vertex(to_delete);
-    --(g -> vertex_count);
-
-    return;
+    free(c.frontier);
+    free(c.visited);
+    return c.t;
 
 }
 
-
 /*
- * finds a vertex given the data and the graph teh vertex  should be in
- * returns null if no vertex found
+ * Weighted shortest paths. Edge weights come from the label dictionary,
+ * where they were parsed once per distinct label.
  */
 
-struct vertex * get_vertex(struct graph *g, struct map *data)
+/*
+ * The weight of edge e of g.
+ */
+static double _edge_weight(struct graph *g, struct edge *e)
 {
 
-    if (g == 0){
-        printf("graph not found. get_vertex() failed.");
-    }
+    return e -> label >= 0 ? g -> labels.weights[e -> label] : 1.0;
 
-    if (data == 0){
-        printf("data doesn't exist. get_vertex() failed.");
+}
 
-    }
+/*
+ * An entry of the heap of dijkstra_lazy; stale once dist[id] is lower.
+ */
+struct heap_entry {
 
-    //traverse the graph's list of vertices until we find the node, return it
-    struct vertex *current = g -> vertex_head;
-    while(current){
+    double dist;
+    int id;
 
-        if (current -> data == data){
-            return current;
-        }
+};
 
-        current = current -> next_vertex;
+/*
+ * Moves heap[i] up, then down, to its place in a binary min-heap of
+ * vertex ids keyed by dist, keeping pos[id] at each id's index.
+ */
+static void _heap_fix(int *heap, int n, int *pos, double *dist, int i)
+{
 
+    int id = heap[i];
+    while (i > 0 && dist[heap[(i - 1) / 2]] > dist[id]){
+        heap[i] = heap[(i - 1) / 2];
+        pos[heap[i]] = i;
+        i = (i - 1) / 2;
     }
-
-    return 0;
+    for (;;){
+        int child = 2 * i + 1;
+        if (child >= n){
+            break;
+        }
+        if (child + 1 < n && dist[heap[child + 1]] < dist[heap[child]]){
+            ++child;
+        }
+        if (dist[heap[child]] >= dist[id]){
+            break;
+        }
+        heap[i] = heap[child];
+        pos[heap[i]] = i;
+        i = child;
+    }
+    heap[i] = id;
+    pos[id] = i;
 
 }
 
 /*
- * modifies the vertex given the new data, deletes old node from graph g and adds new one to g
+ * Like _heap_fix for the heap entries of dijkstra_lazy.
  */
-void modify_vertex(struct graph *g, struct map *old, struct map *new)
+static void _entry_heap_fix(struct heap_entry *heap, int n, int i)
 {
 
-    if(g == 0){
-        printf("graph not found. modify_vertex() failed.");
-        return ;
+    struct heap_entry x = heap[i];
+    while (i > 0 && heap[(i - 1) / 2].dist > x.dist){
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
     }
-
-    if(old == 0){
-        printf("no old data. modify_vertex() failed.");
-        return ;
+    for (;;){
+        int child = 2 * i + 1;
+        if (child >= n){
+            break;
+        }
+        if (child + 1 < n && heap[child + 1].dist < heap[child].dist){
+            ++child;
+        }
+        if (heap[child].dist >= x.dist){
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
     }
+    heap[i] = x;
 
-    if (new == 0){
-        printf("no new data. modify_vertex() failed.");
-        return ;
-    }
+}
 
-    delete_vertex(g, old);
-    add_vertex(g, new);
+void free_shortest_paths(struct shortest_paths *p)
+{
 
-    return;
+    if (p){
+        free(p -> dist);
+        free(p -> pred);
+        free(p);
+    }
 
 }
 
+#define SETTLED -2
+
 /*
- * add edge function, creates a new edge between two edges, only does it one way
- * it will make the edge from g to v
- *
+ * Dijkstra's algorithm from vertex s, stopping once target (if not -1)
+ * is settled. With lazy set every improvement pushes a new heap entry;
+ * otherwise the vertex's one entry is lowered in place. Edges weighing
+ * HUGE_VAL are skipped; a negative or NaN weight fails the search,
+ * which then returns NULL.
  */
-void _add_edge(struct graph *g, struct map *v, struct map *f, char *data)
+static struct shortest_paths * _dijkstra(struct graph *g, int s, int target, int lazy)
 {
 
-    if (g == 0){
-        printf("graph not found. failed at add_edge().");
-        return;
+    int n = g -> vertex_slots;
+    struct shortest_paths *p = malloc(sizeof(struct shortest_paths));
+    int *pos = malloc((n + 1) * sizeof(int)), *heap = NULL;
+    struct heap_entry *entries = NULL;
+    int capacity = g -> edge_count + 1;
+    if (p){
+        p -> dist = malloc((n + 1) * sizeof(double));
+        p -> pred = malloc((n + 1) * sizeof(int));
     }
-    if (v == 0 || f == 0){
-        printf("map not found, invalid data. failed at add_edge().");
-        return;
-
+    if (lazy){
+        entries = malloc(capacity * sizeof(struct heap_entry));
+    }
+    else {
+        heap = malloc((n + 1) * sizeof(int));
+    }
+    if (p == NULL || p -> dist == NULL || p -> pred == NULL || pos == NULL || (lazy ? entries == NULL : heap == NULL)){
+        printf("malloc failed at shortest paths\n");
+        free_shortest_paths(p);
+        free(pos);
+        free(heap);
+        free(entries);
+        return NULL;
     }
 
+    p -> vertex_slots = n;
+    int id, i;
+    for (id = 0; id < n; ++id){
+        p -> dist[id] = HUGE_VAL;
+        p -> pred[id] = -1;
+    }
+    double *dist = p -> dist;
+    dist[s] = 0;
+
+    //pos[id] is id's place in the heap, -1 before it is reached and
+    //SETTLED after; the lazy heap only uses the last
+    int size = 1;
+    memset(pos, -1, n * sizeof(int));
+    if (lazy){
+        entries[0].dist = 0;
+        entries[0].id = s;
+    }
+    else {
+        heap[0] = s;
+        pos[s] = 0;
+    }
 
-    if(!get_vertex(g,v)) { add_vertex(g,v); }
-    if(!get_vertex(g,f)) { add_vertex(g,f); }
-
-    //this will find the edges in the graph and return them
-    struct vertex *v_vertex = get_vertex(g, v);
-    struct vertex *f_vertex = get_vertex(g, f);
-
-    int i = _find_edge(g, v, f);
-    if (i == 0){
-        //go through each of the edge lists
-        struct edge *new_edge_v = _new_edge(v_vertex, f_vertex, data);
-        //all the edges for that vertex
-        struct edge *v_edges = v_vertex -> connected_edges;
-
-        if(v_vertex -> connected_edges == 0){
-            v_vertex -> connected_edges  = new_edge_v;
-            ++ (g -> edge_count);
-            return;
+    while (size > 0 && p){
+        int u;
+        if (lazy){
+            struct heap_entry top = entries[0];
+            entries[0] = entries[--size];
+            if (size > 0){
+                _entry_heap_fix(entries, size, 0);
+            }
+            if (top.dist > dist[top.id] || pos[top.id] == SETTLED){
+                continue;
+            }
+            u = top.id;
+            pos[u] = SETTLED;
         }
-
-        while(v_edges -> next != NULL){
-            v_edges = v_edges -> next;
+        else {
+            u = heap[0];
+            heap[0] = heap[--size];
+            if (size > 0){
+                _heap_fix(heap, size, pos, dist, 0);
+            }
+            pos[u] = SETTLED;
         }
-
-        v_edges -> next = new_edge_v;
+        if (u == target){
+            break;
         }
 
-    else{
-        printf("There is already an edge between the two vertices!\n");
+        struct vertex *v = &g -> vertices[u];
+        for (i = 0; i < v -> edge_slots; ++i){
+            struct edge *e = &v -> connected_edges[i];
+            if (e -> to < 0){
+                continue;
+            }
+            double w = _edge_weight(g, e);
+            if (!(w >= 0)){
+                printf("edge weight \"%s\" is negative or not a number. shortest paths failed.\n", _edge_label(g, e));
+                free_shortest_paths(p);
+                p = NULL;
+                break;
+            }
+            if (w == HUGE_VAL || pos[e -> to] == SETTLED){
+                continue;
+            }
+            double d = dist[u] + w;
+            if (d >= dist[e -> to]){
+                continue;
+            }
+            dist[e -> to] = d;
+            p -> pred[e -> to] = u;
+            if (lazy){
+                if (size == capacity){
+                    struct heap_entry *grown = realloc(entries, 2 * capacity * sizeof(struct heap_entry));
+                    if (grown == NULL){
+                        printf("malloc failed at shortest paths\n");
+                        break;
+                    }
+                    entries = grown;
+                    capacity *= 2;
+                }
+                entries[size].dist = d;
+                entries[size].id = e -> to;
+                _entry_heap_fix(entries, size + 1, size);
+                ++size;
+            }
+            else if (pos[e -> to] == -1){
+                heap[size] = e -> to;
+                _heap_fix(heap, size + 1, pos, dist, size);
+                ++size;
+            }
+            else {
+                _heap_fix(heap, size, pos, dist, pos[e -> to]);
+            }
+        }
     }
 
+    free(pos);
+    free(heap);
+    free(entries);
+    return p;
+
 }
 
-void add_wedge(struct graph *g, struct map *v, char *data, struct map *f) {
-    _add_edge(g, v, f, data);
+struct shortest_paths * dijkstra(struct graph *g, struct map *src)
+{
+
+    int s = g ? get_vertex_id(g, src) : -1;
+    if (s < 0){
+        printf("vertex not found! dijkstra()\n");
+        return NULL;
+    }
+    return _dijkstra(g, s, -1, 0);
+
 }
 
-void add_edge(struct graph *g, struct map *v, struct map *f) {
-    _add_edge(g, v, f, "");
+struct shortest_paths * dijkstra_lazy(struct graph *g, struct map *src)
+{
+
+    int s = g ? get_vertex_id(g, src) : -1;
+    if (s < 0){
+        printf("vertex not found! dijkstra_lazy()\n");
+        return NULL;
+    }
+    return _dijkstra(g, s, -1, 1);
+
 }
+
 /*
- * deletes an edge between the two given vertices in graph g
+ * Searches from a until b is settled. Returns NULL if either is not a
+ * vertex of g, and sets *target to b's id.
  */
-void delete_edge(struct graph *g, struct map *v, struct map *f)
+static struct shortest_paths * _path_search(struct graph *g, struct map *a, struct map *b, int *target)
 {
 
-    if (g == 0){
-        printf("Graph not found. delete_edge() failed.");
-        return;
+    int s = g ? get_vertex_id(g, a) : -1;
+    *target = g ? get_vertex_id(g, b) : -1;
+    if (s < 0 || *target < 0){
+        printf("vertex not found! shortest_path()\n");
+        return NULL;
     }
+    return _dijkstra(g, s, *target, 1);
 
-    if(v ==  0 || f == 0){
-        printf("Maps don't exist. delete_edge() failed.");
-        return;
+}
+
+struct list * shortest_path(struct graph *g, struct map *a, struct map *b)
+{
+
+    int t;
+    struct list *path = make_list();
+    struct shortest_paths *p = _path_search(g, a, b, &t);
+    if (p && p -> dist[t] != HUGE_VAL){
+        for (; t >= 0; t = p -> pred[t]){
+            add_head(path, g -> vertices[t].data);
+        }
     }
+    free_shortest_paths(p);
+    return path;
 
-    struct vertex *v_vertex = get_vertex(g, v);
-    struct vertex *f_vertex = get_vertex(g, f);
+}
 
-    //if either of the edges are in the graph then fail
-    if (v_vertex == 0 || f_vertex == 0){
-        printf("vertex not found. failed at add_edge()");
-        return;
+double shortest_distance(struct graph *g, struct map *a, struct map *b)
+{
+
+    int t;
+    struct shortest_paths *p = _path_search(g, a, b, &t);
+    double d = p && p -> dist[t] != HUGE_VAL ? p -> dist[t] : -1;
+    free_shortest_paths(p);
+    return d;
+
+}
+
+/*
+ * PageRank, by pulling: every vertex sums the shares of the vertices
+ * with an edge to it, read from an in-edge CSR built per call. The
+ * inner loops are branch-free and run over contiguous arrays, with
+ * the sums split over several accumulators, so the compiler can
+ * vectorize them. Threads split the vertices by in-edge count.
+ */
+
+struct _pagerank_context {
+    int *offsets;       //in-edges of v are sources[offsets[v] .. offsets[v + 1])
+    int *sources;
+    double *inverse;    //1 / out-degree, or 0 for vertices with no out-edges
+    double *dangling;   //1 for live vertices with no out-edges, else 0
+    double *live;       //1 for live vertices, else 0
+    double *rank;
+    double *next;
+    double *share;      //rank[u] * inverse[u]
+    double base;
+    double damping;
+    double sum;         //dangling mass in the share step, change in the rank step
+    pthread_mutex_t lock;
+};
+
+static void _pagerank_share(void *arg, int begin, int end)
+{
+
+    struct _pagerank_context *c = arg;
+    double dangling = 0;
+    int u;
+    for (u = begin; u < end; ++u){
+        c -> share[u] = c -> rank[u] * c -> inverse[u];
+        dangling += c -> rank[u] * c -> dangling[u];
     }
+    pthread_mutex_lock(&c -> lock);
+    c -> sum += dangling;
+    pthread_mutex_unlock(&c -> lock);
 
-    struct edge *v_edges = v_vertex -> connected_edges;
-    while (v_edges -> next != 0){
-        struct edge *tmp = v_edges -> next;
-        if (tmp -> to == f_vertex){
-            v_edges -> next = tmp -> next;
-            _free_edge(tmp);
-            return;
+}
+
+static void _pagerank_pull(void *arg, int begin, int end)
+{
+
+    struct _pagerank_context *c = arg;
+    double change = 0;
+    int v, i;
+    for (v = begin; v < end; ++v){
+        int lo = c -> offsets[v], hi = c -> offsets[v + 1];
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (i = lo; i + 3 < hi; i += 4){
+            s0 += c -> share[c -> sources[i]];
+            s1 += c -> share[c -> sources[i + 1]];
+            s2 += c -> share[c -> sources[i + 2]];
+            s3 += c -> share[c -> sources[i + 3]];
         }
-        v_edges = v_edges -> next;
+        for (; i < hi; ++i){
+            s0 += c -> share[c -> sources[i]];
+        }
+        double r = c -> live[v] * (c -> base + c -> damping * ((s0 + s1) + (s2 + s3)));
+        double d = r - c -> rank[v];
+        change += d < 0 ? -d : d;
+        c -> next[v] = r;
     }
+    pthread_mutex_lock(&c -> lock);
+    c -> sum += change;
+    pthread_mutex_unlock(&c -> lock);
 
 }
 
-int _find_edge(struct graph *g, struct map *v, struct map *f)
+double * pagerank(struct graph *g, double damping, int iters, double tol)
 {
 
     if (g == 0){
-        printf("Graph not found. find_edge() failed.");
+        printf("Graph doesn't exist. pagerank() failed.");
         return 0;
     }
 
-    if(v ==  0 || f == 0){
-        printf("Maps don't exist. find_edge() failed.");
+    int n = g -> vertex_slots;
+    struct _pagerank_context c;
+    c.offsets = malloc((n + 1) * sizeof(int));
+    c.sources = malloc((g -> edge_count + 1) * sizeof(int));
+    c.inverse = malloc((n + 1) * sizeof(double));
+    c.dangling = malloc((n + 1) * sizeof(double));
+    c.live = malloc((n + 1) * sizeof(double));
+    c.rank = malloc((n + 1) * sizeof(double));
+    c.next = malloc((n + 1) * sizeof(double));
+    c.share = malloc((n + 1) * sizeof(double));
+    if (c.offsets == 0 || c.sources == 0 || c.inverse == 0 || c.dangling == 0
+            || c.live == 0 || c.rank == 0 || c.next == 0 || c.share == 0){
+        printf("malloc failed at pagerank()\n");
+        free(c.offsets);
+        free(c.sources);
+        free(c.inverse);
+        free(c.dangling);
+        free(c.live);
+        free(c.rank);
+        free(c.next);
+        free(c.share);
         return 0;
     }
 
-    struct vertex *v_vertex = get_vertex(g, v);
-    struct vertex *f_vertex = get_vertex(g, f);
-
-    //if either of the vertex are in the graph then fail
-    if (v_vertex == 0 || f_vertex == 0){
-        printf("vertex not found. failed at find_edge()\n");
-        return 0;
+    int v, i, e = 0;
+    for (v = 0; v < n; ++v){
+        struct vertex *x = &g -> vertices[v];
+        int live = x -> data != 0;
+        c.offsets[v] = e;
+        for (i = 0; live && i < x -> in_degree; ++i){
+            c.sources[e++] = x -> in_edges[i];
+        }
+        c.live[v] = live;
+        c.inverse[v] = live && x -> degree > 0 ? 1.0 / x -> degree : 0;
+        c.dangling[v] = live && x -> degree == 0;
+        c.rank[v] = live ? 1.0 / g -> vertex_count : 0;
     }
-
-    struct edge *v_edges = v_vertex -> connected_edges;
-    while(v_edges != 0){
-
-        if (v_edges -> to == f_vertex){
-            return 1;
+    c.offsets[n] = e;
+
+    c.damping = damping;
+    pthread_mutex_init(&c.lock, NULL);
+    int iter;
+    for (iter = 0; iter < iters && g -> vertex_count > 0; ++iter){
+        c.sum = 0;
+        _parallel_for(n, _pagerank_share, &c);
+        c.base = ((1 - damping) + damping * c.sum) / g -> vertex_count;
+
+        c.sum = 0;
+        _parallel_for_weighted(n, c.offsets, _pagerank_pull, &c);
+        double *swap = c.rank;
+        c.rank = c.next;
+        c.next = swap;
+        if (c.sum < tol){
+            break;
         }
-
-        v_edges = v_edges -> next;
-
     }
+    pthread_mutex_destroy(&c.lock);
 
-    return 0;
+    free(c.offsets);
+    free(c.sources);
+    free(c.inverse);
+    free(c.dangling);
+    free(c.live);
+    free(c.next);
+    free(c.share);
+    return c.rank;
 
 }
 
-void _modify_edge(struct graph *g, struct map *v, struct map *f, char *data)
+struct list * pagerank_list(struct graph *g, double damping, int iters, double tol)
 {
 
-    if (g == 0){
-        printf("Graph not found. find_edge() failed.");
-        return ;
+    struct list *scores = make_list();
+    double *rank = pagerank(g, damping, iters, tol);
+    if (rank == 0){
+        return scores;
     }
 
-    if(v ==  0 || f == 0){
-        printf("Maps don't exist. find_edge() failed.");
-        return ;
+    int id;
+    for (id = 0; id < g -> vertex_slots; ++id){
+        if (g -> vertices[id].data){
+            add_tail_dec(scores, rank[id]);
+        }
     }
+    free(rank);
+    return scores;
 
-    struct vertex *v_vertex = get_vertex(g, v);
-    struct vertex *f_vertex = get_vertex(g, f);
+}
 
-    //if either of the edges are in the graph then fail
-    if (v_vertex == 0 || f_vertex == 0){
-        printf("vertex not found. failed at add_edge()");
-        return ;
-    }
+/*
+ * Connected components. Weak components come from a union-find shared
+ * by all threads: roots are linked with a compare-and-swap, always the
+ * larger id under the smaller, so every root ends up the smallest id
+ * of its component whatever order the edges are seen in, and finds
+ * halve their paths as they go. Strong components come from Tarjan's
+ * algorithm, with an explicit stack in place of recursion.
+ */
 
-    struct edge *v_edges = v_vertex -> connected_edges;
-    while(v_edges != 0){
+/*
+ * Returns the root of x in the union-find parent, halving the path.
+ */
+static int _uf_find(int *parent, int x)
+{
 
-        if (v_edges -> to == f_vertex){
-            v_edges -> data = data;
-            return;
+    int p = __atomic_load_n(&parent[x], __ATOMIC_RELAXED);
+    while (p != x){
+        int gp = __atomic_load_n(&parent[p], __ATOMIC_RELAXED);
+        if (gp != p){
+            //fails harmlessly if someone else moved x first
+            __atomic_compare_exchange_n(&parent[x], &p, gp, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
         }
-
-        v_edges = v_edges -> next;
-
+        x = gp;
+        p = __atomic_load_n(&parent[x], __ATOMIC_RELAXED);
     }
+    return x;
 
 }
 
 /*
- * This will create a new graph that has the nodes that are in both
- * g and h. The nodes are not connected.
+ * Joins the sets of a and b.
  */
-struct graph * intersection_graph(struct graph *g, struct graph *h)
+static void _uf_union(int *parent, int a, int b)
 {
 
-    if (g == 0 || h == 0){
-        printf("Graph doesn't exist. intersection_graphs() failed.");
-        return 0;
+    for (;;){
+        a = _uf_find(parent, a);
+        b = _uf_find(parent, b);
+        if (a == b){
+            return;
+        }
+        if (a < b){
+            int swap = a;
+            a = b;
+            b = swap;
+        }
+        //a is only linked if it is still a root
+        int expected = a;
+        if (__atomic_compare_exchange_n(&parent[a], &expected, b, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)){
+            return;
+        }
     }
 
-    struct graph *i = new_graph();
+}
 
-    // if either graphs are empty, return the new empty graph
-    if (g -> vertex_count == 0 ||  h -> vertex_count == 0){
-        return i;
-    }
+struct _components_context {
+    struct graph *g;
+    int *parent;
+};
 
-    struct vertex *current = g -> vertex_head;
+static void _union_edge_range(void *arg, int begin, int end)
+{
 
-    while (current){
+    struct _components_context *c = arg;
+    int id, i;
+    for (id = begin; id < end; ++id){
+        struct vertex *v = &c -> g -> vertices[id];
+        for (i = 0; i < v -> edge_slots; ++i){
+            if (v -> connected_edges[i].to >= 0){
+                _uf_union(c -> parent, id, v -> connected_edges[i].to);
+            }
+        }
+    }
 
-        struct map *d = current -> data;
+}
 
-        if (get_vertex(h, d)){
-            add_vertex(i, d);
-        }
+static void _find_root_range(void *arg, int begin, int end)
+{
 
-        current = current -> next_vertex;
+    struct _components_context *c = arg;
+    int id;
+    for (id = begin; id < end; ++id){
+        int root = c -> g -> vertices[id].data ? _uf_find(c -> parent, id) : -1;
+        __atomic_store_n(&c -> parent[id], root, __ATOMIC_RELAXED);
     }
 
-    return i;
 }
 
-/*
- * Union of two graphs, returns a new graph with all the nodes in both graphs,
- * unconnected.
- */
-struct graph * union_graph(struct graph *g, struct graph *h)
+int * weak_components(struct graph *g)
 {
 
-    if (g == 0 || h == 0){
-        printf("Graph doesn't exist. union_graphs() failed.");
+    if (g == 0){
+        printf("Graph doesn't exist. weak_components() failed.");
         return 0;
     }
 
-    struct graph *i = new_graph();
+    int n = g -> vertex_slots;
+    int *parent = malloc((n + 1) * sizeof(int));
+    int *offsets = _edge_offsets(g);
+    if (parent == NULL || offsets == NULL){
+        printf("malloc failed at weak_components()\n");
+        free(parent);
+        free(offsets);
+        return 0;
+    }
 
-    //if both graphs are empty, return the new empty graph
-    if (g -> vertex_count == 0 && h -> vertex_count == 0){
-        return i;
+    int id;
+    for (id = 0; id < n; ++id){
+        parent[id] = id;
+    }
+
+    struct _components_context c = {g, parent};
+    _parallel_for_weighted(n, offsets, _union_edge_range, &c);
+    //roots never change now, so every vertex can look its root up at once
+    _parallel_for(n, _find_root_range, &c);
+
+    free(offsets);
+    return parent;
+
+}
+
+int * strong_components(struct graph *g)
+{
+
+    if (g == 0){
+        printf("Graph doesn't exist. strong_components() failed.");
+        return 0;
     }
 
-    struct vertex *current_g = g -> vertex_head;
-    struct vertex *current_h = h -> vertex_head;
+    int n = g -> vertex_slots;
+    int *component = malloc((n + 1) * sizeof(int));
+    int *index = malloc((n + 1) * sizeof(int));
+    int *low = malloc((n + 1) * sizeof(int));
+    int *next = malloc((n + 1) * sizeof(int));
+    int *calls = malloc((n + 1) * sizeof(int));
+    int *stack = malloc((n + 1) * sizeof(int));
+    if (component == NULL || index == NULL || low == NULL || next == NULL || calls == NULL || stack == NULL){
+        printf("malloc failed at strong_components()\n");
+        free(component);
+        free(index);
+        free(low);
+        free(next);
+        free(calls);
+        free(stack);
+        return 0;
+    }
 
-    while (current_g){
-        add_vertex(i, current_g -> data);
-        current_g = current_g -> next_vertex;
+    //component[id] is -2 while id is on the stack
+    int id, root, counter = 0, size = 0;
+    for (id = 0; id < n; ++id){
+        component[id] = -1;
+        index[id] = -1;
     }
 
-    while (current_h){
-        if (!get_vertex(i, current_h -> data)){
-            add_vertex(i, current_h -> data);
+    for (root = 0; root < n; ++root){
+        if (g -> vertices[root].data == 0 || index[root] >= 0){
+            continue;
         }
-        current_h = current_h -> next_vertex;
 
+        int top = 0;
+        calls[0] = root;
+        index[root] = low[root] = counter++;
+        next[root] = _first_edge(g, root);
+        stack[size++] = root;
+        component[root] = -2;
+
+        while (top >= 0){
+            int u = calls[top];
+            int to = _next_neighbor(g, u, &next[u]);
+            if (to >= 0){
+                if (index[to] < 0){
+                    index[to] = low[to] = counter++;
+                    next[to] = _first_edge(g, to);
+                    stack[size++] = to;
+                    component[to] = -2;
+                    calls[++top] = to;
+                }
+                else if (component[to] == -2 && index[to] < low[u]){
+                    low[u] = index[to];
+                }
+                continue;
+            }
+
+            //u is done: hand its low up, and pop its component if it heads one
+            if (--top >= 0 && low[u] < low[calls[top]]){
+                low[calls[top]] = low[u];
+            }
+            if (low[u] == index[u]){
+                int first = size, smallest = u;
+                do {
+                    --first;
+                    if (stack[first] < smallest){
+                        smallest = stack[first];
+                    }
+                } while (stack[first] != u);
+                while (size > first){
+                    component[stack[--size]] = smallest;
+                }
+            }
+        }
     }
 
-    return i;
+    free(index);
+    free(low);
+    free(next);
+    free(calls);
+    free(stack);
+    return component;
+
 }
 
 /*
- * Adds the two given graphs together and returns resulting graph.
+ * Lists component in the order of get_all_vertices, relabeling each
+ * component by the position of its smallest id, and frees component.
  */
-struct graph * add (struct graph *g, struct graph *h){
+static struct list * _components_list(struct graph *g, int *component)
+{
 
-    if (g == 0 || h == 0){
-        printf("Graph doesn't exist. union_graphs() failed.");
-        return 0;
+    struct list *labels = make_list();
+    if (component == 0){
+        return labels;
     }
 
-    struct graph *i = new_graph();
-
-    //if both graphs are empty, return the new empty graph
-    if (g -> vertex_count == 0 && h -> vertex_count == 0){
-        return i;
+    //a component's smallest id comes first, so its position is known by then
+    int id, position = 0;
+    for (id = 0; id < g -> vertex_slots; ++id){
+        if (g -> vertices[id].data == 0){
+            continue;
+        }
+        if (component[id] == id){
+            component[id] = position;
+        }
+        else {
+            component[id] = component[component[id]];
+        }
+        add_tail_int(labels, component[id]);
+        ++position;
     }
+    free(component);
+    return labels;
+
+}
+
+struct list * weak_components_list(struct graph *g)
+{
+
+    return _components_list(g, weak_components(g));
+
+}
+
+struct list * strong_components_list(struct graph *g)
+{
+
+    return _components_list(g, strong_components(g));
 
-    struct vertex *current_g = g -> vertex_head;
-    struct vertex *current_h = h -> vertex_head;
+}
 
-    while (current_g){
-        add_vertex(i, current_g -> data);
-        current_g = current_g -> next_vertex;
+void _clean_graph(struct graph *G){
+    if(G == NULL)
+    {
+        printf("Are you seriously trying to free a null graph?\n");
+        return;
     }
-
-     while (current_h){
-        add_vertex(i, current_h -> data);
-        current_h = current_h -> next_vertex;
+    _unfreeze_graph(G);
+    _free_all_vertex(G);
+    _index_free(&G -> index);
+    while (G -> attr_indexes){
+        struct attr_index *next = G -> attr_indexes -> next;
+        _attr_index_free(G -> attr_indexes);
+        G -> attr_indexes = next;
     }
-
-    return i;
+    _label_dict_free(&G -> labels);
+    _drop_columns(G);
+    free(G -> vertices);
+    free(G -> free_ids);
+    int k;
+    for (k = 0; k < EDGE_SLAB_CLASSES; ++k){
+        slab_release(&G -> edge_slabs[k]);
+    }
+    free(G);
 
 }
 
-
 /*
- * Given a graph and a node, return all the edges given that node.
+ * Frees the vertex's map and marks its slot as unused.
+ * Its edges must already have been freed.
  */
-struct list *_get_edges(struct graph *g, struct map *data){
-
-    if (g == 0){
-        printf("Graph doesn't exist. union_graphs() failed.");
-        return 0;
+void _free_vertex(struct vertex *v){
+    if(v){
+        free_map(v -> data);
+        v -> data = 0;
     }
 
-    if (data == 0){
-        printf("Data doesn't exist. get_edges() failed.");
-    }
+}
 
-    struct vertex *current_vertex = get_vertex(g, data);
+void _free_all_vertex(struct graph *g)
+{
 
-    struct list *edges_queue = make_list();
-    struct edge *current_edge = current_vertex -> connected_edges;
-    while(current_edge){
-        add_tail(edges_queue, current_edge -> data);
-        current_edge = current_edge -> next;
+    int id;
+    for (id = 0; id < g -> vertex_slots; ++id)
+    {
+        struct vertex *current = &g -> vertices[id];
+        if (current -> data)
+        {
+            _free_adjacency_row(g, current);
+            _free_vertex(current);
+        }
     }
-    return edges_queue;
+    g -> vertex_count = 0;
+    g -> edge_count = 0;
+
 }
 
+
 /*
- * Given a graph and a node, return the list of vertices that the vertex given connected to.
+ * Frees every edge leaving V, and V's record of the edges coming in.
+ * Returns how many edges left V.
  */
-struct list *get_edge_neighbors(struct graph *g, struct map *data){
+int _free_adjacency_row(struct graph *g, struct vertex *V)
+{
 
-    if (g == 0){
-        printf("Graph doesn't exist. union_graphs() failed.");
-        return 0;
-    }
-    if (data == 0){
-        printf("Data doesn't exist. get_edges() failed.");
+    int count = V -> degree;
+    if (V -> edge_capacity > 0){
+        _edge_array_free(g, V -> connected_edges, V -> edge_capacity);
     }
+    _edge_set_free(V -> targets);
+    _label_groups_free(V);
+    free(V -> in_edges);
+    _edge_set_free(V -> sources);
+    V -> connected_edges = 0;
+    V -> targets = 0;
+    V -> edge_slots = 0;
+    V -> edge_capacity = 0;
+    V -> degree = 0;
+    V -> nth_index = -1;
+    V -> in_edges = 0;
+    V -> sources = 0;
+    V -> in_degree = 0;
+    V -> in_capacity = 0;
+    return count;
+}
 
-    struct vertex *current_vertex = get_vertex(g, data);
 
-    struct list *edges_queue = make_list();
-    struct edge *current_edge = current_vertex -> connected_edges;
-    while(current_edge){
-        add_tail(edges_queue, current_edge->to->data);
-        current_edge = current_edge -> next;
-    }
-    return edges_queue;
+/*
+ * LIST METHODS
+ */
 
-}
+#define LIST_MIN_CAPACITY 8
 
-struct list *get_all_vertices(struct graph *g){
+/*
+ * A list keeps its elements in a chunk, a ring buffer that other lists
+ * may share after a concat. Shared chunks are never written: a list
+ * copies its chunk before changing it (copy on write). A concatenation
+ * is kept as a rope of shared pieces until an element is first read or
+ * written, when it is flattened into a chunk of its own.
+ */
 
-    struct list *all_vertices = make_list();
+/*
+ * The slot of the element at index i; capacity is a power of two.
+ */
+#define LIST_SLOT(l, i) (((l)->start + (i)) & ((l)->chunk->capacity - 1))
 
-    struct vertex *v = g -> vertex_head;
+static struct list_chunk * _chunk_alloc(int capacity) {
 
-    while(v != 0){
-        add_tail(all_vertices, v->data);
-        v = v -> next_vertex;
-    }
+	struct list_chunk *c = malloc(sizeof(struct list_chunk) + capacity * sizeof(union data_type));
+	if (c == NULL)
+		return NULL;
+	c->refs = 1;
+	c->capacity = capacity;
+	return c;
+}
 
-    return all_vertices;
+static void _chunk_release(struct list_chunk *c) {
 
+	if (c && --c->refs == 0)
+		free(c);
 }
 
 /*
- * prints out all the edges and nodes of a graph
+ * Drops a reference to a rope, freeing the nodes nobody else holds.
+ * Walks with an explicit stack since ropes built in a loop are deep.
  */
-void printg(struct graph *g){
+static void _rope_release(struct list_rope *r) {
 
+	struct list_rope **stack = NULL;
+	int top = 0, capacity = 0;
 
-    struct vertex *v = g -> vertex_head;
+	while (r) {
+		struct list_rope *next = NULL;
+		if (--r->refs == 0) {
+			if (r->chunk) {
+				_chunk_release(r->chunk);
+			}
+			else {
+				if (top == capacity) {
+					capacity = capacity ? 2 * capacity : 16;
+					stack = realloc(stack, capacity * sizeof(struct list_rope *));
+				}
+				stack[top++] = r->right;
+				next = r->left;
+			}
+			free(r);
+		}
+		if (next == NULL && top > 0)
+			next = stack[--top];
+		r = next;
+	}
+	free(stack);
+}
 
-    while (v){
-        struct map *tmp = v->data;
+/*
+ * Copies the elements of rope r, in order, into items.
+ */
+static void _rope_copy(struct list_rope *r, union data_type *items) {
 
-        printf("%s", "vertex data:\n");
-        print_vertex(tmp);
+	struct list_rope **stack = NULL;
+	int top = 0, capacity = 0, n = 0;
 
+	while (r) {
+		struct list_rope *next = NULL;
+		if (r->chunk) {
+			int i;
+			for (i = 0; i < r->size; ++i)
+				items[n++] = r->chunk->items[(r->start + i) & (r->chunk->capacity - 1)];
+		}
+		else {
+			if (top == capacity) {
+				capacity = capacity ? 2 * capacity : 16;
+				stack = realloc(stack, capacity * sizeof(struct list_rope *));
+			}
+			stack[top++] = r->right;
+			next = r->left;
+		}
+		if (next == NULL && top > 0)
+			next = stack[--top];
+		r = next;
+	}
+	free(stack);
+}
 
-        _print_edge(v -> connected_edges);
+/*
+ * Returns a new reference to the current contents of l as a rope,
+ * sharing its chunk or rope, or NULL if l is empty.
+ */
+static struct list_rope * _list_share(struct list *l) {
 
-        v = v -> next_vertex;
+	if (l->size == 0)
+		return NULL;
+	if (l->rope) {
+		++l->rope->refs;
+		return l->rope;
+	}
 
-        printf("\n");
+	struct list_rope *leaf = malloc(sizeof(struct list_rope));
+	if (leaf == NULL)
+		return NULL;
+	leaf->refs = 1;
+	leaf->size = l->size;
+	leaf->left = leaf->right = NULL;
+	leaf->chunk = l->chunk;
+	leaf->start = l->start;
+	++l->chunk->refs;
+	return leaf;
+}
 
-    }
+/*
+ * Gives l a chunk of its own with room for at least n elements, copying
+ * the elements so that index 0 is at slot 0. Flattens a pending rope.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _list_reserve(struct list *l, int n) {
 
-}
+	if (l->rope == NULL && l->chunk && l->chunk->refs == 1 && n <= l->chunk->capacity)
+		return 1;
 
-void print_vertex(struct map *m){
+	int capacity = LIST_MIN_CAPACITY;
+	while (capacity < n)
+		capacity *= 2;
+	if (l->chunk && l->chunk->capacity > capacity)
+		capacity = l->chunk->capacity;
 
-	struct map_node *current = m->node_head;
-	while (current != NULL) {
+	struct list_chunk *chunk = _chunk_alloc(capacity);
+	if (chunk == NULL)
+		return 0;
 
-		printf("\"%s\" : \"%s\"", current->key, current->value);
-		if (current->next != NULL)
-			printf(" , ");
-		else
-			printf("\n");
-		current = current->next;
+	if (l->rope) {
+		_rope_copy(l->rope, chunk->items);
+		_rope_release(l->rope);
+		l->rope = NULL;
+	}
+	else {
+		int i;
+		for (i = 0; i < l->size; ++i)
+			chunk->items[i] = l->chunk->items[LIST_SLOT(l, i)];
+		_chunk_release(l->chunk);
 	}
 
+	l->chunk = chunk;
+	l->start = 0;
+	return 1;
 }
 
-void _print_edge(struct edge *e){
-
-    if (e){
-        while(e != 0){
-            printf("%s: %s\n", "Edge data", e->data);
-            printf("Connected to: ");
-            print_vertex(e->to->data);
+/*
+ * Returns the slot holding element i for reading, or NULL if i is out
+ * of range.
+ */
+static union data_type * _list_at(struct list *l, int i) {
 
-            e = e -> next;
+	if (i >= l->size || i < 0)
+		return NULL;
+	if (l->rope && !_list_reserve(l, l->size))
+		return NULL;
 
-        }
-    }
+	return &l->chunk->items[LIST_SLOT(l, i)];
 }
 
-
 /*
- * Graph clean up functions.
+ * Like _list_at, but first makes sure the chunk is l's alone.
  */
+static union data_type * _list_write_at(struct list *l, int i) {
 
-void _clean_graph(struct graph *G){
-    if(G == NULL)
-    {
-        printf("Are you seriously trying to free a null graph?\n");
-        return;
-    }
-    _free_all_vertex(G);
-    free(G);
+	if (i >= l->size || i < 0)
+		return NULL;
+	if (!_list_reserve(l, l->size))
+		return NULL;
 
+	return &l->chunk->items[LIST_SLOT(l, i)];
 }
 
-void _free_vertex(struct vertex *v){
-    if(v){
-        v -> next_vertex = 0;
-        _free_edge(v -> connected_edges);
-        free_map(v -> data);
-        free(v);
-    }
-
-}
+static int _list_push_head(struct list *l, union data_type item) {
 
+	if (!_list_reserve(l, l->size + 1))
+		return 0;
 
-void _free_edge(struct edge* e){
+	l->start = (l->start - 1) & (l->chunk->capacity - 1);
+	l->chunk->items[l->start] = item;
+	++l->size;
+	return 1;
+}
 
-    if(e){
+static int _list_push_tail(struct list *l, union data_type item) {
 
-        e -> to = 0;
-        e -> from = 0;
-        free(e);
+	if (!_list_reserve(l, l->size + 1))
+		return 0;
 
-    }
+	l->chunk->items[LIST_SLOT(l, l->size)] = item;
+	++l->size;
+	return 1;
 }
 
-void _free_all_vertex(struct graph *g)
-{
+/*
+ * Removes the first element into *item. Only l's bounds change, so a
+ * shared chunk needs no copy.
+ * Returns a 1 if there was one and 0 if the list is empty.
+ */
+static int _list_pop_head(struct list *l, union data_type *item) {
 
-    struct vertex * current = g -> vertex_head;
-    while(current)
-    {
-        struct vertex *tmp = current;
-        _free_adjacency_row(current);
-        current = current -> next_vertex;
-        _free_vertex(tmp);
-    }
+	if (l->size == 0)
+		return 0;
+	if (l->rope && !_list_reserve(l, l->size))
+		return 0;
 
+	*item = l->chunk->items[l->start];
+	l->start = LIST_SLOT(l, 1);
+	l->size -= 1;
+	return 1;
 }
 
+static int _list_pop_tail(struct list *l, union data_type *item) {
 
-void _free_adjacency_row(struct vertex *V)
-{
-
-    struct edge * current = V -> connected_edges;
-    while(current)
-    {
-        struct edge *tmp = current;
-        current = current -> next;
-        _free_edge(tmp);
+	if (l->size == 0)
+		return 0;
+	if (l->rope && !_list_reserve(l, l->size))
+		return 0;
 
-    }
+	l->size -= 1;
+	*item = l->chunk->items[LIST_SLOT(l, l->size)];
+	return 1;
 }
 
-
-/*
- * LIST METHODS
- */
-
 /*
  * Initializes an empty list.
  */
@@ -962,7 +4985,9 @@ struct list * make_list() {
 		return NULL;
 
 	l->size = 0;
-        l->head = 0;
+	l->start = 0;
+	l->chunk = NULL;
+	l->rope = NULL;
 	return l;
 }
 
@@ -979,17 +5004,8 @@ int size(struct list *l) {
  */
 void * list_get(struct list *l, int i) {
 
-	if (l->head == NULL || i >= l->size || i < 0)
-		return NULL;
-
-	struct list_node *current = l->head;
-	int j = 0;
-	while (j != i) {
-		current = current->next;
-                ++j;
-	}
-
-	return current->data;
+	union data_type *item = _list_at(l, i);
+	return item ? item->p : NULL;
 }
 
 /*
@@ -999,17 +5015,11 @@ void * list_get(struct list *l, int i) {
  */
 int set(struct list *l, int i, void *data) {
 
-	if (l->head == NULL || i >= l->size || i < 0)
+	union data_type *item = _list_write_at(l, i);
+	if (item == NULL)
 		return 0;
 
-	struct list_node *current = l->head;
-	int j = 0;
-	while (j != i) {
-		current = current->next;
-        ++j;
-	}
-
-	current->data = data;
+	item->p = data;
 	return 1;
 }
 
@@ -1019,15 +5029,8 @@ int set(struct list *l, int i, void *data) {
  */
 int add_head(struct list *l, void *data) {
 
-	struct list_node *node = (struct list_node *)malloc(sizeof(struct list_node));
-	if (node == NULL)
-		return 0;
-
-	node->data = data;
-	node->next = l->head;
-	l->head = node;
-	++l->size;
-	return 1;
+	union data_type item = { .p = data };
+	return _list_push_head(l, item);
 }
 
 /*
@@ -1036,28 +5039,8 @@ int add_head(struct list *l, void *data) {
  */
 int add_tail(struct list *l, void *data) {
 
-	struct list_node *node = (struct list_node *)malloc(sizeof(struct list_node));
-	if (node == NULL) {
-		return 0;
-	}
-	node->data = data;
-	node->next = NULL;
-
-	/* if the list is empty, this node is the head */
-  if (l->head == NULL) {
-      ++l->size;
-		  l->head = node;
-		  return 1;
-  }
-	struct list_node *current = l->head;
-	while (current->next != NULL) {
-		current = current->next;
-	}
-
-	/* current is now the last node in the list */
-	current->next = node;
-	++l->size;
-	return 1;
+	union data_type item = { .p = data };
+	return _list_push_tail(l, item);
 }
 
 /*
@@ -1065,15 +5048,8 @@ int add_tail(struct list *l, void *data) {
  */
 void * remove_head(struct list *l) {
 
-	if (l->head == NULL)
-		return NULL;
-
-	struct list_node *oldHead = l->head;
-	l->head = oldHead->next;
-	void *data = oldHead->data;
-	free(oldHead);
-	l->size -= 1;
-	return data;
+	union data_type item;
+	return _list_pop_head(l, &item) ? item.p : NULL;
 }
 
 /*
@@ -1081,27 +5057,19 @@ void * remove_head(struct list *l) {
  */
 void * remove_tail(struct list *l) {
 
-	if (l->head == NULL)
-		return NULL;
-
-	if (l->head->next == NULL) {
-		return remove_head(l);
-	}
-
-	struct list_node *slow = l->head;
-	struct list_node *fast = l->head->next;
+	union data_type item;
+	return _list_pop_tail(l, &item) ? item.p : NULL;
+}
 
-	while (fast->next != NULL) {
-		slow = fast;
-		fast = fast->next;
-	}
+/*
+ * Frees allocated memory for a list.
+ * The elements themselves are not freed.
+ */
+void free_list(struct list *l) {
 
-	/* slow is now the second to last node in the list */
-	void *data = fast->data;
-	slow->next = NULL;
-	l->size -= 1;
-	free(fast);
-	return data;
+	_rope_release(l->rope);
+	_chunk_release(l->chunk);
+	free(l);
 }
 
 /*
@@ -1111,18 +5079,17 @@ void * remove_tail(struct list *l) {
 void printl(struct list *l) {
 
 	printf("[");
-	struct list_node *current = l->head;
-	while (current != NULL)
+	int i;
+	for (i = 0; i < l->size; ++i)
         {
-            if(current -> next == NULL)
+            if(i == l->size - 1)
             {
-                printf("%d", *(int *) current -> data);
+                printf("%d", list_get_int(l, i));
             }
             else
             {
-                printf("%d,", *(int *)current->data);
+                printf("%d,", list_get_int(l, i));
             }
-            current = current->next;
 	}
 
 	printf("]\n");
@@ -1130,105 +5097,170 @@ void printl(struct list *l) {
 
 /*
  * Build a new list that is concatenating two lists.
+ * This is O(1): the result shares a and b as they are now, and is
+ * only copied out once it is read or changed. Later changes to a or b
+ * do not show through.
  */
 struct list * concat(struct list * a, struct list * b) {
 	struct list *  new_list = make_list();
-	struct list_node * current = a -> head;
-	while (current) {
-		add_tail(new_list, current -> data);
-		current = current -> next;
+	if (new_list == NULL)
+		return NULL;
+
+	struct list_rope *left = _list_share(a);
+	struct list_rope *right = _list_share(b);
+	if ((left == NULL && a -> size > 0) || (right == NULL && b -> size > 0)) {
+		_rope_release(left);
+		_rope_release(right);
+		free(new_list);
+		return NULL;
+	}
+
+	if (left && right) {
+		struct list_rope *node = malloc(sizeof(struct list_rope));
+		if (node == NULL) {
+			_rope_release(left);
+			_rope_release(right);
+			free(new_list);
+			return NULL;
+		}
+		node->refs = 1;
+		node->size = left->size + right->size;
+		node->left = left;
+		node->right = right;
+		node->chunk = NULL;
+		node->start = 0;
+		new_list -> rope = node;
 	}
-	current = b -> head;
-	while(current) {
-		add_tail(new_list, current -> data);
-		current = current -> next;
+	else {
+		new_list -> rope = left ? left : right;
 	}
+	new_list -> size = a -> size + b -> size;
 	return new_list;
 
 }
 
-/* For use of primitive int casted to void * for generic linked list*/
+/* Ints, doubles and bools are stored in the slots themselves, unboxed.
+ * Reading past either end gives 0. */
 int add_head_int (struct list * l, int data)
 {
-    int * d = malloc(sizeof(int));
-    *d = data;
-    return add_head(l, d);
+    union data_type item = { .i = data };
+    return _list_push_head(l, item);
 }
 
 int add_tail_int (struct list * l, int data)
 {
-    int * d = malloc(sizeof(int));
-    *d = data;
-    return add_tail(l, d);
+    union data_type item = { .i = data };
+    return _list_push_tail(l, item);
 }
 
 int list_get_int(struct list * l, int index)
 {
-    void * answer = list_get(l, index);
-    return *(int *) answer;
+    union data_type *item = _list_at(l, index);
+    return item ? item -> i : 0;
 }
 
 int list_set_int(struct list * l, int index, int E)
 {
-    int answer = list_get_int(l, index);
-    int * d = malloc(sizeof(int));
-    *d = E;
-    set(l, index, (void *) d);
+    union data_type *item = _list_write_at(l, index);
+    if (item == NULL)
+        return 0;
+    int answer = item -> i;
+    item -> i = E;
     return answer;
 }
 
 int remove_head_int(struct list * l)
 {
-    void * answer = remove_head(l);
-    return *(int *) answer;
+    union data_type item;
+    return _list_pop_head(l, &item) ? item.i : 0;
 }
 
 int remove_tail_int(struct list * l)
 {
-    void * answer = remove_tail(l);
-    return *(int *) answer;
+    union data_type item;
+    return _list_pop_tail(l, &item) ? item.i : 0;
 }
 
 /* For use of linked list using doubles*/
 int add_head_dec (struct list * l, double data)
 {
-    double * d = malloc(sizeof(double));
-    *d = data;
-    return add_head(l, d);
+    union data_type item = { .f = data };
+    return _list_push_head(l, item);
 }
 
 int add_tail_dec (struct list * l, double data)
 {
-    double * d = malloc(sizeof(double));
-    *d = data;
-    return add_tail(l, d);
+    union data_type item = { .f = data };
+    return _list_push_tail(l, item);
 }
 
 double list_get_dec(struct list * l, int index)
 {
-    void * answer = list_get(l, index);
-    return *(double *) answer;
+    union data_type *item = _list_at(l, index);
+    return item ? item -> f : 0;
 }
 
 double list_set_dec(struct list * l, int index, double E)
 {
-    double answer = list_get_dec(l, index);
-    double * d = malloc(sizeof(double));
-    *d = E;
-    set(l, index, (void *) d);
+    union data_type *item = _list_write_at(l, index);
+    if (item == NULL)
+        return 0;
+    double answer = item -> f;
+    item -> f = E;
     return answer;
 }
 
 double remove_head_dec(struct list * l)
 {
-    void * answer = remove_head(l);
-    return *(double *) answer;
+    union data_type item;
+    return _list_pop_head(l, &item) ? item.f : 0;
 }
 
 double remove_tail_dec(struct list * l)
 {
-    void * answer = remove_tail(l);
-    return *(double *) answer;
+    union data_type item;
+    return _list_pop_tail(l, &item) ? item.f : 0;
+}
+
+/* For use of list using bools*/
+int add_head_bool (struct list * l, bool data)
+{
+    union data_type item = { .b = data };
+    return _list_push_head(l, item);
+}
+
+int add_tail_bool (struct list * l, bool data)
+{
+    union data_type item = { .b = data };
+    return _list_push_tail(l, item);
+}
+
+bool list_get_bool(struct list * l, int index)
+{
+    union data_type *item = _list_at(l, index);
+    return item ? item -> b : false;
+}
+
+bool list_set_bool(struct list * l, int index, bool E)
+{
+    union data_type *item = _list_write_at(l, index);
+    if (item == NULL)
+        return false;
+    bool answer = item -> b;
+    item -> b = E;
+    return answer;
+}
+
+bool remove_head_bool(struct list * l)
+{
+    union data_type item;
+    return _list_pop_head(l, &item) ? item.b : false;
+}
+
+bool remove_tail_bool(struct list * l)
+{
+    union data_type item;
+    return _list_pop_tail(l, &item) ? item.b : false;
 }
 
 /* For use of linked list using strings*/
@@ -1293,7 +5325,7 @@ struct map * list_get_map(struct list * l, int index)
 struct map *list_set_map(struct list * l, int index, struct map * E)
 {
     struct map * answer = list_get_map(l, index);
-    set(l, index, (void *) &E);
+    set(l, index, (void *) E);
     return answer;
 }
 
@@ -1359,39 +5391,133 @@ int * myAtoi(char * str)
 
 char * concat_string(char * a, char * b)
 {
-    char * c = malloc(strlen(a) + strlen(b) + 1);
-    sprintf(c, "%s%s", a, b);
-    c[strlen(a) + strlen(b)] = '\0';
+    int a_len = STRING_HEADER(a)->length;
+    int b_len = STRING_HEADER(b)->length;
+    struct string_header * h = malloc(sizeof(struct string_header) + a_len + b_len + 1);
+    if (h == NULL)
+        return NULL;
+    char * c = (char *) (h + 1);
+    memcpy(c, a, a_len);
+    memcpy(c + a_len, b, b_len + 1);
+    h->length = a_len + b_len;
+    h->hash = _hash_extend(STRING_HEADER(a)->hash, b, b_len);
+    h->interned = 0;
     return c;
 }
 
+/*
+ * Initializes an empty string builder.
+ */
+struct string_builder * make_builder()
+{
+    struct string_builder * sb = malloc(sizeof(struct string_builder));
+    if (sb == NULL)
+        return NULL;
+    sb->buf = NULL;
+    sb->length = 0;
+    sb->capacity = 0;
+    sb->value = NULL;
+    return sb;
+}
+
+/*
+ * Makes room for n more characters and the terminating NUL,
+ * doubling the buffer.
+ * Returns a 1 if successful and 0 otherwise.
+ */
+static int _builder_reserve(struct string_builder * sb, size_t n)
+{
+    if (sb->length + n + 1 <= sb->capacity)
+        return 1;
+
+    size_t capacity = sb->capacity ? sb->capacity : 16;
+    while (capacity < sb->length + n + 1)
+        capacity *= 2;
+    char * buf = realloc(sb->buf, capacity);
+    if (buf == NULL)
+        return 0;
+    sb->buf = buf;
+    sb->capacity = capacity;
+    return 1;
+}
+
+/*
+ * Appends s to the builder in amortized O(strlen(s)).
+ */
+void builder_append(struct string_builder * sb, char * s)
+{
+    size_t n = STRING_HEADER(s)->length;
+    if (!_builder_reserve(sb, n))
+        return;
+    memcpy(sb->buf + sb->length, s, n + 1);
+    sb->length += n;
+    sb->value = NULL;
+}
+
+/*
+ * Replaces the contents of the builder with s.
+ * s itself is what builder_string returns until the next append.
+ */
+void builder_set(struct string_builder * sb, char * s)
+{
+    sb->length = 0;
+    builder_append(sb, s);
+    sb->value = s;
+}
+
+/*
+ * Returns the contents of the builder as a string of its own, which
+ * later appends leave alone. The copy is made once per change.
+ */
+char * builder_string(struct string_builder * sb)
+{
+    if (sb->value == NULL)
+        sb->value = sb->length > 0 ? make_string(sb->buf, sb->length) : EMPTY_STRING;
+    return sb->value;
+}
+
+/*
+ * Frees a string builder. Strings returned by builder_string are
+ * not freed.
+ */
+void free_builder(struct string_builder * sb)
+{
+    free(sb->buf);
+    free(sb);
+}
+
 int length(char * s)
 {
-    return strlen(s);
+    return STRING_HEADER(s)->length;
 }
 
 int str_comp(char * a, char * b)
 {
-    int ans = strcmp(a, b);
-    //fprintf(stderr, "Didn't seg yet: %d\n", ans);
-    return (ans == 0);
+    struct string_header * ha = STRING_HEADER(a);
+    struct string_header * hb = STRING_HEADER(b);
+    if (a == b)
+        return 1;
+    if (ha->interned && hb->interned)
+        return 0;
+    if (ha->length != hb->length || ha->hash != hb->hash)
+        return 0;
+    return memcmp(a, b, ha->length) == 0;
 }
 
 // Ocaml views chars as ints. Ocaml should have a convert back! C.decode()?
 // See Ocaml Char module!
+// The result is one of 256 shared strings, so nothing is allocated.
 char * get_char(char * s, int idx)
 {
-    int size = strlen(s);
+    int size = STRING_HEADER(s)->length;
     if(idx < 0 || idx > size)
     {
         return NULL;
     }
     else
     {
-	char * i = malloc(sizeof(char) * 2);
-	i[0] = s[idx];
-	i[1] = '\0';
-        return i;
+        pthread_once(&_char_strings_once, _init_char_strings);
+        return _char_strings[(unsigned char) s[idx]].chars;
     }
 }
 
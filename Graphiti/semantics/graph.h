@@ -6,25 +6,91 @@
 #include <stdio.h>
 #include <stdbool.h>
 
+/*
+ * SLAB METHODS
+ */
+
+/*
+ * A slab hands out fixed-size objects carved from large chunks,
+ * so objects of one type sit next to each other in memory.
+ * Freed objects go on a free list for reuse; every chunk is
+ * released at once by slab_release.
+ */
+struct slab_chunk;
+
+struct slab {
+	int object_size;
+	int chunk_objects;
+	struct slab_chunk *chunks;
+	void *free_objects;
+	char *cursor;
+	int remaining;
+};
+
+/*
+ * Initializes a slab for objects of the given size.
+ */
+void slab_init(struct slab *s, int object_size);
+
+/*
+ * Returns an uninitialized object, or NULL if out of memory.
+ */
+void * slab_alloc(struct slab *s);
+
+/*
+ * Gives an object back to the slab it came from.
+ */
+void slab_free(struct slab *s, void *object);
+
+/*
+ * Frees every chunk of the slab, and with them all of its objects.
+ */
+void slab_release(struct slab *s);
+
+
 /*
  * MAP METHODS
  */
 
 /*
  * Map node declaration.
+ * Nodes live in one array in insertion order; a removed node
+ * keeps its place with a NULL key until the map is compacted.
  */
 struct map_node {
 	char *key;
 	char *value;
-	struct map_node *next;
+	unsigned int hash;
+	unsigned int value_hash;
+};
+
+/*
+ * Open-addressing slot. The key hash is stored next to the
+ * node index so probes rarely have to touch the node itself.
+ */
+struct map_slot {
+	unsigned int hash;
+	int index;
 };
 
 /*
  * Map declaration.
+ * 'slots' is a linear-probing table of 'capacity' entries
+ * (a power of two, 0 until the first put) indexing into 'nodes'.
+ * 'used' counts nodes handed out, including removed ones.
+ * Both arrays share one allocation, which comes from a slab
+ * while the map is small.
+ * 'fingerprint' is the sum of a hash of every key-value pair,
+ * kept up to date by put and remove_node. Maps with the same
+ * contents have the same fingerprint, whatever their order.
  */
 struct map {
-	struct map_node *node_head;
+	struct map_node *nodes;
+	struct map_slot *slots;
 	int size;
+	int used;
+	int capacity;
+	unsigned int fingerprint;
 };
 
 /*
@@ -43,6 +109,16 @@ int put(struct map *m, char *key, char *value);
  */
 char * map_get(struct map *m, char *key);
 
+/*
+ * put, map_get, contains_key and remove_node for keys that are
+ * strings with a header (see STRING METHODS), whose hash is reused.
+ * The compiler calls these.
+ */
+int put_str(struct map *m, char *key, char *value);
+char * map_get_str(struct map *m, char *key);
+int contains_key_str(struct map *m, char *key);
+int remove_node_str(struct map *m, char *key);
+
 /*
  * Returns 1 if a key is found in a map
  * and 0 otherwise.
@@ -63,10 +139,16 @@ int contains_value(struct map *m, char *value);
 int remove_node(struct map *m, char *key);
 
 /*
- * Compares two maps for equality.
+ * Compares two maps for equality: same keys, with values of the
+ * same contents. Maps whose fingerprints differ are rejected at once.
  */
 int is_equal(struct map *m1, struct map *m2);
 
+/*
+ * Returns the fingerprint of a map; equal maps have equal ones.
+ */
+unsigned int map_fingerprint(struct map *m);
+
 /*
  * Frees allocated memory for a map.
  */
@@ -86,28 +168,300 @@ void printm(struct map *m);
  * GRAPH METHODS
  */
 
+/*
+ * An edge between two vertices, named by their ids in the graph.
+ * 'to' is -1 once the edge has been deleted. The edge's data is
+ * the label with id 'label' in the graph's label dictionary, or
+ * NULL if 'label' is -1.
+ */
 struct edge {
 
-    struct vertex *from;
-    struct vertex *to;
-    struct edge *next;
-    char *data;
+    int from;
+    int to;
+    int label;
 
 };
 
+/*
+ * Dictionary of the edge labels of a graph. Each distinct label is
+ * kept once, in names, and edges refer to it by its index there.
+ * slots is a linear-probing table of label ids, -1 when empty.
+ * last is the id looked up most recently, checked first since
+ * edges are often added in runs with the same label.
+ * weights holds each label read as a number, parsed once when the
+ * label is added, so weighted searches never parse edge data;
+ * labels that are not numbers weigh 1.
+ */
+struct label_dict {
+
+    char **names;
+    unsigned int *hashes;
+    double *weights;
+    int count;
+    int capacity;
+    int *slots;
+    int slot_capacity;
+    int last;
+
+};
+
+/*
+ * A vertex's live edges grouped by label. The edges labelled
+ * labels[k] are at positions[offsets[k]] .. positions[offsets[k + 1] - 1]
+ * of connected_edges, in insertion order; labels is sorted.
+ */
+struct label_groups {
+
+    int count;
+    int *labels;
+    int *offsets;
+    int *positions;
+
+};
+
+/*
+ * Set of the targets of a vertex's edges, mapping each target id to
+ * the edge's position in connected_edges. Open addressing with linear
+ * probing; empty slots hold -1.
+ */
+struct edge_set {
+
+    int *targets;
+    int *positions;
+    int size;
+    int capacity;
+
+};
+
+/*
+ * A vertex lives in its graph's 'vertices' array; its index there
+ * is its id. Deleted slots have NULL data and are reused by later
+ * vertices, so the id of a live vertex never changes.
+ *
+ * connected_edges holds the out-edges in insertion order. Deleted
+ * edges leave a dead slot behind until the array is compacted, so
+ * walk the first edge_slots entries and skip those with 'to' < 0.
+ * 'degree' counts live edges; 'targets' is only built once degree
+ * passes a small threshold, below which a scan is cheaper.
+ *
+ * in_edges lists the ids of the vertices with an edge to this one,
+ * in no particular order; deleting one moves the last into its place.
+ * Like targets, 'sources' maps each of them to its position there
+ * once in_degree passes the threshold.
+ *
+ * nth_index is the last i whose live edge get_neighbor_at or
+ * get_edge_at looked up, and nth_slot that edge's slot; nth_index is
+ * -1 once an edge is deleted.
+ *
+ * groups indexes the edges by label for get_neighbors_by_label. It is
+ * built on the first such query once degree passes the threshold and
+ * dropped whenever the vertex's edges change.
+ */
 struct vertex {
 
     struct edge *connected_edges;
-    struct vertex *next_vertex;
+    int edge_slots;
+    int edge_capacity;
+    int degree;
+    struct edge_set *targets;
+    int *in_edges;
+    int in_degree;
+    int in_capacity;
+    struct edge_set *sources;
+    int nth_index;
+    int nth_slot;
+    struct label_groups *groups;
     struct map *data; /*should this be a void pointer or a struct map pointer */
 
 };
 
+/*
+ * Hash index from a vertex's map to the vertex's id.
+ * Open addressing with linear probing; empty slots have a NULL key.
+ */
+struct vertex_index {
+
+    struct map **keys;
+    int *ids;
+    int size;
+    int capacity;
+
+};
+
+/*
+ * Compressed sparse row snapshot of a graph. The edges of the vertex
+ * with id v are targets[offsets[v]] .. targets[offsets[v + 1] - 1],
+ * in insertion order, with their data at the same positions of
+ * edge_data. Ids are those of the graph; unused ids have NULL
+ * vertex_data and no edges.
+ */
+struct csr_graph {
+
+    int vertex_slots;
+    int edge_count;
+    int *offsets;
+    int *targets;
+    char **edge_data;
+    struct map **vertex_data;
+
+};
+
+/*
+ * The vertices holding one value of an indexed attribute, by id,
+ * in no particular order.
+ */
+struct attr_bucket {
+
+    char *value;
+    unsigned int hash;
+    int *ids;
+    int count;
+    int capacity;
+
+};
+
+/*
+ * Secondary index on the attribute key: maps each value of key to the
+ * vertices whose map has it. Linear probing over the buckets; empty
+ * slots have a NULL value. add_vertex, delete_vertex and modify_vertex
+ * keep it current, but a value changed in place with put is not seen.
+ * id_buckets[id] is the slot of the bucket vertex id is filed in, -1
+ * if none, and id_positions[id] its place in that bucket's ids, so a
+ * vertex is taken out without searching for it.
+ */
+struct attr_index {
+
+    char *key;
+    struct attr_bucket *buckets;
+    int size;
+    int capacity;
+    int *id_buckets;
+    int *id_positions;
+    int id_capacity;
+    struct attr_index *next;
+
+};
+
+/*
+ * One column of the attribute store: values[id] is the value of key
+ * in the map of vertex id, or NULL if it has none.
+ */
+struct attr_column {
+
+    char *key;
+    char **values;
+
+};
+
+/*
+ * Column store of vertex attributes, built by columnize_graph. Keys
+ * held by at least half of the vertices get a column indexed by vertex
+ * id; rarer keys are only found in the vertex maps. Like the frozen
+ * snapshot it is dropped when vertices are added or deleted. Values
+ * changed in place with put are not seen; fingerprints[id] is the
+ * fingerprint of vertex id's map when the store was built, so readers
+ * can tell which rows are out of date.
+ */
+struct attr_columns {
+
+    int vertex_slots;
+    int count;
+    struct attr_column *columns;
+    unsigned int *fingerprints;
+
+};
+
+/*
+ * Result of a bfs or dfs from one vertex. order lists the ids of the
+ * vertices reached, in visit order. depth and parent are indexed by
+ * vertex id and hold -1 for vertices not reached; the source is at
+ * depth 0 with parent -1. For dfs, depth is the depth in the search
+ * tree.
+ */
+struct traversal {
+
+    int vertex_slots;
+    int count;
+    int *order;
+    int *depth;
+    int *parent;
+
+};
+
+/*
+ * Result of a single-source shortest path search. dist and pred are
+ * indexed by vertex id: dist is the total weight of a lightest path
+ * from the source, HUGE_VAL if there is none, and pred the vertex
+ * before this one on that path, -1 for the source and vertices not
+ * reached.
+ */
+struct shortest_paths {
+
+    int vertex_slots;
+    double *dist;
+    int *pred;
+
+};
+
+#define EDGE_SLAB_CLASSES 3
+
+/*
+ * Vertex ids run from 0 to vertex_slots - 1, so per-vertex side
+ * arrays (visited flags, distances, ...) can be indexed by id.
+ * free_ids is a stack of deleted slots waiting to be reused.
+ * edge_slabs[k] holds the edge arrays of capacity 4 << k, which
+ * is what most vertices need; bigger arrays are malloc'ed.
+ * frozen is the snapshot built by freeze_graph, or NULL.
+ * labels holds the data of the edges; see struct label_dict.
+ * attr_indexes lists the indexes made by index_attribute.
+ * columns is the attribute store built by columnize_graph, or NULL.
+ */
 struct graph {
 
     int vertex_count;
     int edge_count;
-    struct vertex *vertex_head;
+    struct vertex *vertices;
+    int vertex_slots;
+    int vertex_capacity;
+    int *free_ids;
+    int free_count;
+    struct vertex_index index;
+    struct slab edge_slabs[EDGE_SLAB_CLASSES];
+    struct csr_graph *frozen;
+    struct label_dict labels;
+    struct attr_index *attr_indexes;
+    struct attr_columns *columns;
+
+};
+
+/*
+ * Cursor over the edges leaving one vertex, kept on the caller's stack:
+ *
+ *     struct edge_iter it;
+ *     for (edge_iter_init(&it, g, v); edge_iter_next(&it); )
+ *         ... it.neighbor, it.data ...
+ *
+ * edges is NULL when the cursor walks the frozen snapshot instead.
+ */
+struct edge_iter {
+
+    struct graph *g;
+    struct edge *edges;
+    int pos;
+    int end;
+    struct map *neighbor;
+    char *data;
+
+};
+
+/*
+ * Cursor over the vertices of a graph, in id order.
+ */
+struct vertex_iter {
+
+    struct graph *g;
+    int id;
+    struct map *data;
 
 };
 
@@ -122,18 +476,14 @@ struct graph * new_graph();
  */
 struct vertex * new_vertex(struct map *data);
 
-/*
- * creates new struct from a to b with the input data
- */
-struct edge * new_edge(struct vertex *a, struct vertex *b, char *data);
-
 /*
  * decides whether to call modify vertext or delete vertex *
  */
 void modify_graph(struct graph *g, struct map *from, char *data, struct map *to, int dec);
 
 /*
- * create a new vertex with map data and adds it to g, returns vertex created
+ * create a new vertex with map data and adds it to g,
+ * does nothing if the map is already a vertex of g
  */
 void add_vertex(struct graph *g, struct map *data);
 
@@ -144,9 +494,15 @@ void delete_vertex(struct graph *g, struct map *data);
 
 /*
  * finds the vertex given the map and returns it, returns null if nothing found
+ * the pointer is only valid until the next vertex is added to g
  */
 struct vertex * get_vertex(struct graph *g, struct map *data);
 
+/*
+ * returns the id of the vertex holding the map, or -1 if there is none
+ */
+int get_vertex_id(struct graph *g, struct map *data);
+
 /*
  * modifies the vertx given the new data –
  * deletes the old node from graph g and adds new graph into g
@@ -169,6 +525,12 @@ void add_edge(struct graph *g, struct map *a, struct map *b);
  */
 void add_wedge(struct graph *g, struct map *a, char *data, struct map *b);
 
+/*
+ * adds n edges from[i] -> to[i] with data[i] in one go, as if by add_wedge;
+ * where to[i] is NULL only the vertex from[i] is added
+ */
+void add_batch(struct graph *g, struct map **from, char **data, struct map **to, int n);
+
 /*
  * deletes an edge given the two nodes the edge is between
  */
@@ -187,20 +549,36 @@ int _find_edge(struct graph *g, struct map *from, struct map *to);
 void _modify_edge(struct graph *g, struct map *v, struct map *f, char *data);
 
 /*
- * intersection
+ * intersection: the vertices in both, and the edges in both with g's data
  */
 struct graph * intersection_graph(struct graph *g, struct graph *h);
 
 /*
- * union
+ * union: every vertex and edge of either; edges in both keep g's data
  * */
 struct graph * union_graph(struct graph *g, struct graph *h);
 
 /*
- * adds the two given graphs together and returns resulting graph
+ * adds the two given graphs together and returns resulting graph;
+ * like union, but edges in both take h's data
  */
 struct graph * add (struct graph *g, struct graph *h);
 
+/*
+ * merges the vertices of g whose maps are equal (see is_equal) into
+ * the first of them, which takes over their edges; returns how many
+ * vertices were removed. The merged maps are left alone, so they can
+ * still be read or be vertices of other graphs
+ */
+int dedupe_vertices(struct graph *g);
+
+/*
+ * sets how many threads the graph operators may use on large graphs
+ * (default 1, serial)
+ */
+void graph_set_threads(int n);
+int graph_get_threads();
+
 /*
  * given a graph and a node, return all the edges given that node
  */
@@ -213,20 +591,162 @@ struct list * get_all_vertices(struct graph *g);
 
 struct list * get_edge_neighbors(struct graph *g, struct map *data);
 
+/*
+ * given a graph and a node, return the nodes that have an edge to it
+ */
+struct list * get_in_neighbors(struct graph *g, struct map *data);
+
+/*
+ * given a graph, a node and a label, return the nodes the node has an
+ * edge to with that label; only the edges with the label are visited
+ */
+struct list * get_neighbors_by_label(struct graph *g, struct map *data, char *label);
+
+/*
+ * keeps an index of the vertices of g by their value for key, so that
+ * find_vertices on key need not scan the graph
+ */
+void index_attribute(struct graph *g, char *key);
+
+/*
+ * returns the vertices of g whose map has value under key, in id order;
+ * uses the index on key if there is one, and otherwise notes on
+ * stderr that it fell back to a scan
+ */
+struct list * find_vertices(struct graph *g, char *key, char *value);
+
+/*
+ * stores the common attributes of g's vertices column by column, so
+ * that whole-graph scans read them in order; see struct attr_columns
+ */
+struct attr_columns * columnize_graph(struct graph *g);
+
+/*
+ * returns the column of key, indexed by vertex id, or NULL if g has
+ * no column store or key has no column in it
+ */
+char ** get_attribute_column(struct graph *g, char *key);
+
+/*
+ * allocation-free iteration over edges and vertices; see struct edge_iter
+ */
+void edge_iter_init(struct edge_iter *it, struct graph *g, struct map *data);
+int edge_iter_next(struct edge_iter *it);
+void vertex_iter_init(struct vertex_iter *it, struct graph *g);
+int vertex_iter_next(struct vertex_iter *it);
+
+/*
+ * the length and i-th element of get_edge_neighbors, _get_edges and
+ * get_all_vertices, without building the list
+ */
+int vertex_degree(struct graph *g, struct map *data);
+int vertex_total(struct graph *g);
+struct map * get_neighbor_at(struct graph *g, struct map *data, int i);
+char * get_edge_at(struct graph *g, struct map *data, int i);
+struct map * get_vertex_at(struct graph *g, int i);
+
+/*
+ * returns a compressed sparse row snapshot of g for read-only work,
+ * building it if needed. The snapshot belongs to g and stays valid
+ * until g is next modified; read functions use it while it exists.
+ */
+struct csr_graph * freeze_graph(struct graph *g);
+
+/*
+ * breadth-first and depth-first search of g from src, over vertex ids;
+ * see struct traversal. Returns NULL if src is not a vertex of g.
+ */
+struct traversal * bfs(struct graph *g, struct map *src);
+struct traversal * dfs(struct graph *g, struct map *src);
+void free_traversal(struct traversal *t);
+
+/*
+ * the vertices reached by bfs or dfs from src, in visit order, and for
+ * bfs their depths and parents in the same order; the source is its
+ * own parent. These back the Graphiti builtins.
+ */
+struct list * bfs_order(struct graph *g, struct map *src);
+struct list * dfs_order(struct graph *g, struct map *src);
+struct list * bfs_depths(struct graph *g, struct map *src);
+struct list * bfs_parents(struct graph *g, struct map *src);
+
+/*
+ * bfs over the frozen snapshot of g, using up to graph_get_threads()
+ * threads on large graphs. Each level goes top-down from the frontier
+ * or, while the frontier is large, bottom-up from the unvisited
+ * vertices. Depths match bfs; the order within a level, and so the
+ * parents, may differ from run to run.
+ */
+struct traversal * parallel_bfs(struct graph *g, struct map *src);
+
+/*
+ * Dijkstra's algorithm from src, weighing each edge by its data read
+ * as a number (1 if it is not a number). An edge weighing "inf" is
+ * never taken. Reaching an edge with a negative or NaN weight prints
+ * a failure message and gives up.
+ * dijkstra keeps one heap entry per vertex and lowers it in place;
+ * dijkstra_lazy pushes a new entry instead and skips stale ones.
+ * Both return NULL if src is not a vertex of g or the search failed.
+ */
+struct shortest_paths * dijkstra(struct graph *g, struct map *src);
+struct shortest_paths * dijkstra_lazy(struct graph *g, struct map *src);
+void free_shortest_paths(struct shortest_paths *p);
+
+/*
+ * the vertices on a lightest path from a to b, both included, and its
+ * weight; an empty list and -1 if b cannot be reached from a or the
+ * search failed on a negative or NaN weight.
+ * These back the Graphiti builtins.
+ */
+struct list * shortest_path(struct graph *g, struct map *a, struct map *b);
+double shortest_distance(struct graph *g, struct map *a, struct map *b);
+
+/*
+ * PageRank of the vertices of g, indexed by vertex id (0 for unused
+ * ids); the caller frees the array. Runs at most iters iterations,
+ * stopping early once the scores move by less than tol in total.
+ * Vertices without edges share their score with every vertex.
+ * Uses up to graph_get_threads() threads on large graphs.
+ */
+double * pagerank(struct graph *g, double damping, int iters, double tol);
+
+/*
+ * the PageRank scores in the order of get_all_vertices; backs the
+ * Graphiti builtin
+ */
+struct list * pagerank_list(struct graph *g, double damping, int iters, double tol);
+
+/*
+ * connected components of g, ignoring edge direction (weak) or not
+ * (strong), as an array indexed by vertex id that the caller frees:
+ * each vertex gets the smallest id in its component, unused ids -1.
+ * weak_components uses up to graph_get_threads() threads on large
+ * graphs.
+ */
+int * weak_components(struct graph *g);
+int * strong_components(struct graph *g);
+
+/*
+ * the components in the order of get_all_vertices, each vertex labeled
+ * with the position of the first vertex of its component in that
+ * order; these back the Graphiti builtins
+ */
+struct list * weak_components_list(struct graph *g);
+struct list * strong_components_list(struct graph *g);
+
 /*
  * print functions
  */
 void printg(struct graph *g);
-void _print_edge(struct edge *e);
+void _print_edge(struct graph *g, struct vertex *v);
 void print_vertex(struct map *m);
 
 
 /* Clean up methods */
 void _clean_graph(struct graph *G);
-void _free_adjacency_row(struct vertex *V);
+int _free_adjacency_row(struct graph *g, struct vertex *V);
 void _free_all_vertex(struct graph *g);
 void _free_vertex(struct vertex *v);
-void _free_edge(struct edge *e);
 
 /*
 char * to_string(int i) {
@@ -249,25 +769,47 @@ int randint(int low, int high) {
  */
 
 /*
- * A node in a linked list.
+ * One list element. Pointers (maps, strings, lists, graphs) are kept
+ * in p; ints, floats and bools are stored in place, unboxed.
  */
 
 union data_type {
+    void * p;
     int i;
-    float f;
+    double f;
+    bool b;
     char * s;
     struct map * m;
 };
 
-struct list_node {
-    void * data;
-    //union data_type d;
-    struct list_node * next;
+/*
+ * A ring buffer of list elements; capacity is a power of two.
+ * Lists share chunks after a concat, counted by refs, and copy a
+ * shared chunk before writing to it.
+ */
+struct list_chunk {
+    int refs;
+    int capacity;
+    union data_type items[];
 };
 
 /*
- * A linked list.
- * 'head' points to the first node in the list.
+ * A pending concatenation. Leaves hold size elements of chunk starting
+ * at slot start; inner nodes join left and right.
+ */
+struct list_rope {
+    int refs;
+    int size;
+    struct list_rope * left;
+    struct list_rope * right;
+    struct list_chunk * chunk;
+    int start;
+};
+
+/*
+ * A list. Element i is chunk->items[(start + i) & (chunk->capacity - 1)],
+ * so indexing and adding or removing at either end are O(1). A list
+ * made by concat holds a rope instead until it is first read or changed.
  *
  * This will be called generically as in
  * list<int> data;
@@ -275,7 +817,9 @@ struct list_node {
  */
 struct list {
     int size;
-    struct list_node * head;
+    int start;
+    struct list_chunk * chunk;
+    struct list_rope * rope;
 };
 
 /*
@@ -337,7 +881,7 @@ void printl(struct list *l);
  */
 struct list * concat(struct list * a, struct list * b);
 
-/* Testing the int casting to void!*/
+/* Use for ints, stored unboxed */
 int list_get_int (struct list * l, int index);
 int list_set_int (struct list * l, int index, int E);
 int add_head_int (struct list * l, int data);
@@ -345,7 +889,7 @@ int remove_head_int (struct list * l);
 int add_tail_int (struct list * l, int data);
 int remove_tail_int (struct list * l);
 
-/* Use for double/decimals */
+/* Use for double/decimals, stored unboxed */
 double list_get_dec (struct list * l, int index);
 double list_set_dec (struct list * l, int index, double E);
 int add_head_dec (struct list * l, double data);
@@ -353,6 +897,14 @@ double remove_head_dec (struct list * l);
 int add_tail_dec (struct list * l, double data);
 double remove_tail_dec (struct list * l);
 
+/* Use for bools, stored unboxed */
+bool list_get_bool (struct list * l, int index);
+bool list_set_bool (struct list * l, int index, bool E);
+int add_head_bool (struct list * l, bool data);
+bool remove_head_bool (struct list * l);
+int add_tail_bool (struct list * l, bool data);
+bool remove_tail_bool (struct list * l);
+
 /* Use for strings */
 char * list_get_str (struct list * l, int index);
 char * list_set_str (struct list * l, int index, char * E);
@@ -369,11 +921,75 @@ struct map * remove_head_map (struct list * l);
 int add_tail_map (struct list * l, struct map * data);
 struct map * remove_tail_map (struct list * l);
 
+/*
+ * STRING METHODS
+ */
+
+/*
+ * Strings made by the compiler and by the runtime for Graphiti
+ * programs carry a header with their length and FNV-1a hash, so
+ * neither is recomputed. The string points at its characters, which
+ * are still NUL-terminated, and the header sits just before them.
+ * length, str_comp, get_char, concat_string, the string builder and
+ * the *_str map functions expect such strings; plain C strings must
+ * go through make_string first. interned is set on the strings held
+ * by the intern table (see intern_string).
+ */
+struct string_header {
+    int length;
+    unsigned int hash;
+    int interned;
+};
+
+#define STRING_HEADER(s) (((struct string_header *) (s)) - 1)
+
+/*
+ * Makes a string with a header from the first length characters
+ * of chars.
+ */
+char * make_string(const char *chars, int length);
+
+/*
+ * Returns the hash kept in the header of s.
+ */
+unsigned int string_hash(char *s);
+
+/*
+ * Returns the one interned string equal to s, so that equal interned
+ * strings share a pointer. Map keys put by Graphiti programs and edge
+ * data are interned; string literals are interned before main runs.
+ */
+char * intern_string(char *s);
+
+/*
+ * Adds strings already marked as interned to the intern table.
+ * Called once at program start with the program's string literals.
+ */
+void intern_strings(char **strings, int n);
+
 /* Misc Methods. Strops, atoi, etc. */
 int * random_int(int minimum_number, int max_number);
 char * myItoa(int num);
 int * myAtoi(char * str);
 char * concat_string(char * a, char * b);
+
+/*
+ * A string grown by appending, as in s = s + x in a loop.
+ * buf doubles as needed, so an append costs the length of what is
+ * appended. value caches the last string made by builder_string.
+ */
+struct string_builder {
+    char * buf;
+    size_t length;
+    size_t capacity;
+    char * value;
+};
+
+struct string_builder * make_builder();
+void builder_append(struct string_builder * sb, char * s);
+void builder_set(struct string_builder * sb, char * s);
+char * builder_string(struct string_builder * sb);
+void free_builder(struct string_builder * sb);
 int length(char * s);
 int str_comp(char * a, char * b);
 
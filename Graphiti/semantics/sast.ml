@@ -19,6 +19,8 @@ and sx =
   | SAssign of string * sexpr
   | SGraphEdges of sexpr * sexpr
   | SGraphNodes of sexpr * sexpr
+  | SGraphInNodes of sexpr * sexpr
+  | SGraphLabelNodes of sexpr * sexpr * sexpr
   | SGraphAllNodes of sexpr
   | SGraphAll of sexpr
   | SGraphAddVertex of sexpr
@@ -37,6 +39,7 @@ and sx =
   | SList_Rm_Head of sexpr
   | SList_Add_Tail of sexpr * sexpr
   | SOpAssign of string * op * sexpr
+  | SStrAppend of string * sexpr
   | SMapRemoveNode of sexpr * sexpr
   | SMapIsEqual of sexpr * sexpr
   | SCall of string * sexpr list
@@ -55,6 +58,7 @@ type sfunc_decl = {
     sformals : bind list;
     slocals : bind list;
     sbody : sstmt list;
+    sappends : string list; (* strings grown by s = s + x or s += x *)
   }
 
 type sprogram = bind list * sfunc_decl list
@@ -85,6 +89,8 @@ let rec string_of_sexpr (t, e) =
   | SGraphMod(g, l) -> g ^ "{{" ^ String.concat "," (List.map (fun(e) -> string_of_sexpr e) l) ^ "}}"
   | SGraphEdges(g, e) -> string_of_sexpr g ^ ".get_edges(" ^ string_of_sexpr e^ ")"
   | SGraphNodes(g, n) -> string_of_sexpr g ^ ".get_neighbors(" ^ string_of_sexpr n ^ ")"
+  | SGraphInNodes(g, n) -> string_of_sexpr g ^ ".get_in_neighbors(" ^ string_of_sexpr n ^ ")"
+  | SGraphLabelNodes(g, n, l) -> string_of_sexpr g ^ ".get_neighbors_by_label(" ^ string_of_sexpr n ^ ", " ^ string_of_sexpr l ^ ")"
   | SGraphAllNodes(g) -> string_of_sexpr g ^ ".get_all_nodes()"
   | SGraphAll(g) -> string_of_sexpr g ^ ".get_all_nodes()"
   | SStrLit(l) -> l
@@ -94,6 +100,7 @@ let rec string_of_sexpr (t, e) =
   | SUnop(o, e) -> string_of_uop o ^ string_of_sexpr e
   | SAssign(v, e) -> v ^ " = " ^ string_of_sexpr e
   | SOpAssign(v,o,e) -> v ^ " " ^ string_of_op o ^ " " ^ string_of_sexpr e
+  | SStrAppend(v, e) -> v ^ " += " ^ string_of_sexpr e
   | SCall(f, el) ->
       f ^ "(" ^ String.concat ", " (List.map string_of_sexpr el) ^ ")"
   | SNoexpr -> ""
@@ -72,7 +72,14 @@ let check (globals, functions) =
 			formals = [(ty, "x")];
 			locals = []; 
 			body = [] } map
-		in List.fold_left add_bind StringMap.empty [("printi", Int);
+		(* Built-ins that take more than one argument or return a value *)
+		and add_func map (ty, name, formals) = StringMap.add name {
+			typ = ty;
+			fname = name;
+			formals = formals;
+			locals = [];
+			body = [] } map
+		in List.fold_left add_func (List.fold_left add_bind StringMap.empty [("printi", Int);
 													("printb", Bool);
 													("printf", Float);
 													("printbig", Int);
@@ -80,7 +87,22 @@ let check (globals, functions) =
 													("printm", Map);
 													("printl", List(String));
                                                     ("printl", List(Int));
-                                                    ("printg", Graph)]
+                                                    ("printg", Graph);
+                                                    ("freeze", Graph);
+                                                    ("columnize", Graph);
+                                                    ("set_threads", Int)])
+			[(Void, "index_attribute", [(Graph, "g"); (String, "key")]);
+			 (List(Map), "find_vertices", [(Graph, "g"); (String, "key"); (String, "value")]);
+			 (Int, "dedupe_vertices", [(Graph, "g")]);
+			 (List(Map), "bfs", [(Graph, "g"); (Map, "src")]);
+			 (List(Map), "dfs", [(Graph, "g"); (Map, "src")]);
+			 (List(Int), "bfs_depths", [(Graph, "g"); (Map, "src")]);
+			 (List(Map), "bfs_parents", [(Graph, "g"); (Map, "src")]);
+			 (List(Map), "shortest_path", [(Graph, "g"); (Map, "a"); (Map, "b")]);
+			 (Float, "shortest_distance", [(Graph, "g"); (Map, "a"); (Map, "b")]);
+			 (List(Float), "pagerank", [(Graph, "g"); (Float, "damping"); (Int, "iters"); (Float, "tol")]);
+			 (List(Int), "weak_components", [(Graph, "g")]);
+			 (List(Int), "strong_components", [(Graph, "g")])]
 		in
 
 	(* Add function name to symbol table *)
@@ -129,6 +151,9 @@ let check (globals, functions) =
 			with Not_found -> raise (Failure ("undeclared identifier " ^ s))
 		in
 
+		(* String variables appended to with s = s + x or s += x *)
+		let appends = ref [] in
+
 		(* Return a semantically-checked expression, i.e., with a type *)
 			 
 		let rec expr =
@@ -197,17 +222,26 @@ let check (globals, functions) =
             | GraphEdges(g, n) ->
           		let g' = check_graph g
           		and n' = check_node n in
-          		(Graph, SGraphEdges(g', n'))
+          		(List(String), SGraphEdges(g', n'))
        		| GraphNodes(g, n) ->
           		let g' = check_graph g
           		and n' = check_node n in
-				(Graph, SGraphNodes(g', n'))
+				(List(Map), SGraphNodes(g', n'))
+       		| GraphInNodes(g, n) ->
+          		let g' = check_graph g
+          		and n' = check_node n in
+				(List(Map), SGraphInNodes(g', n'))
+       		| GraphLabelNodes(g, n, l) ->
+          		let g' = check_graph g
+          		and n' = check_node n
+          		and l' = check_weight l in
+				(List(Map), SGraphLabelNodes(g', n', l'))
             | GraphAllNodes(g) ->
             	let g' = check_graph g in
-            	(Graph, SGraphAllNodes(g'))
+            	(List(Map), SGraphAllNodes(g'))
             | GraphAll(g) ->
             	let g' = check_graph g in
-            	(Graph, SGraphAll(g'))
+            	(List(Map), SGraphAll(g'))
             | GraphAddVertex(n) ->
             	let n' = check_node n in
             	(Graph, SGraphAddVertex(n'))
@@ -227,6 +261,8 @@ let check (globals, functions) =
             	let n1' = check_node n1
             	and n2' = check_node n2 in
             	(Graph, SGraphDelEdge(n1', n2'))
+            | Assign(var, Binop(Id v, Add, e)) when v = var && type_of_identifier var = String ->
+					string_append var e
             | Assign(var, e) as ex -> 
 					let lt = type_of_identifier var
 					and (rt, e') = expr e in (* recursive *)
@@ -265,6 +301,8 @@ let check (globals, functions) =
 				Failure ("illegal binary operator " ^ string_of_typ t1 ^ " " ^ string_of_op op ^ " " ^
 								 string_of_typ t2 ^ " in " ^ string_of_expr e))
 					in (ty, SBinop((t1, e1'), op, (t2, e2')))
+			| OpAssign(var, Add, e) when type_of_identifier var = String ->
+					string_append var e
 			| OpAssign(var, op, e) as ex -> 
 					let lt = type_of_identifier var
 					and (rt, e2') = expr e in 
@@ -333,6 +371,18 @@ let check (globals, functions) =
 				valid_element_type(expr e);
 				(Void, SList_Add_Tail (expr l, expr e))
 
+
+		(* s = s + x and s += x on strings, lowered to a string builder *)
+		and string_append var e =
+			let (rt, e') = expr e in
+			if rt != String then
+				raise (Failure ("illegal string append " ^ var ^ " + " ^ string_of_typ rt ^
+								" in " ^ string_of_expr e))
+			else begin
+				if not (List.mem var !appends) then appends := var :: !appends;
+				(String, SStrAppend(var, (rt, e')))
+			end
+
             in
 
 		let check_bool_expr e = 
@@ -364,12 +414,15 @@ let check (globals, functions) =
 					in SBlock(check_stmt_list sl)
 
 		in (* body of check_function *)
+		let sbody = match check_stmt (Block func.body) with
+	SBlock(sl) -> sl
+			| _ -> raise (Failure ("internal error: block didn't become a block?"))
+		in
 		{ styp = func.typ;
 			sfname = func.fname;
 			sformals = func.formals;
 			slocals  = func.locals;
-			sbody = match check_stmt (Block func.body) with
-	SBlock(sl) -> sl
-			| _ -> raise (Failure ("internal error: block didn't become a block?"))
+			sbody = sbody;
+			sappends = !appends;
 		}
 	in (globals, List.map check_function functions)
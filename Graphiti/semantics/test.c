@@ -119,7 +119,7 @@ int main(int arg, char **argv) {
     struct vertex *c = g -> vertex_head;
     while (c)
     {
-        struct map_node *tmp = (c->data)->node_head;
+        struct map_node *tmp = (c->data)->nodes;
         printf("%s\n", tmp -> key);
         c = c-> next_vertex;
     }
@@ -136,7 +136,7 @@ int main(int arg, char **argv) {
     struct vertex *c2 = g -> vertex_head;
     while (c2)
     {
-        struct map_node *tmp = (c2->data)->node_head;
+        struct map_node *tmp = (c2->data)->nodes;
         printf("%s\n", tmp -> key);
         c2 = c2-> next_vertex;
     }
@@ -228,7 +228,7 @@ int main(int arg, char **argv) {
     struct vertex *ig = inter -> vertex_head;
     while (ig)
     {
-        struct map_node *tmp = (ig->data)->node_head;
+        struct map_node *tmp = (ig->data)->nodes;
         printf("%s\n", tmp -> key);
         ig = ig-> next_vertex;
     }
@@ -239,7 +239,7 @@ int main(int arg, char **argv) {
     struct vertex *ip = un -> vertex_head;
     while (ip)
     {
-        struct map_node *tmp = (ip->data)->node_head;
+        struct map_node *tmp = (ip->data)->nodes;
         printf("%s\n", tmp -> key);
         ip = ip -> next_vertex;
     }
@@ -249,7 +249,7 @@ int main(int arg, char **argv) {
     struct vertex *ad = a -> vertex_head;
     while (ad)
     {
-        struct map_node *tmp = (ad->data)->node_head;
+        struct map_node *tmp = (ad->data)->nodes;
         printf("%s\n", tmp -> key);
         ad = ad -> next_vertex;
     }
@@ -275,7 +275,7 @@ int main(int arg, char **argv) {
     struct vertex *ii = mg -> vertex_head;
     while (ii)
     {
-        struct map_node *tmp = (ii->data)->node_head;
+        struct map_node *tmp = (ii->data)->nodes;
         printf("%s\n", tmp -> key);
         ii = ii -> next_vertex;
     }
@@ -307,36 +307,84 @@ int main(int arg, char **argv) {
     _add_edge(g, e1, e3, "six");
 
     struct list *k = get_all_vertices(g);
-    struct list_node *cur = k->head;
-    while(cur){
+    int cur;
+    for(cur = 0; cur < size(k); ++cur){
 
-        struct map *tmp = (struct map *)cur->data;
-        printf("%s\n", tmp->node_head->key);
-        cur = cur -> next;
+        struct map *tmp = (struct map *)list_get(k, cur);
+        printf("%s\n", tmp->nodes[0].key);
     }
 
     struct list *bn = _get_edges(g, e1);
-    struct list_node *cur1 = bn->head;
-    while(cur1){
+    int cur1;
+    for(cur1 = 0; cur1 < size(bn); ++cur1){
 
-        char *tmp1 = (char *)cur1->data;
+        char *tmp1 = (char *)list_get(bn, cur1);
         printf("%s\n", tmp1);
-        cur1 = cur1 -> next;
     }
 
     struct list *gn = get_edge_neighbors(g, e1);
-    struct list_node *cur2 = gn->head;
-    while(cur2){
-        struct map *tmp2 = (struct map *)cur2->data;
+    int cur2;
+    for(cur2 = 0; cur2 < size(gn); ++cur2){
+        struct map *tmp2 = (struct map *)list_get(gn, cur2);
         if(tmp2){
-            printf("%s\n", tmp2->node_head->key);
+            printf("%s\n", tmp2->nodes[0].key);
         }
-        cur2 = cur2 -> next;
 
     }
 
     printg(g);
 
+    // testing parallel_bfs against bfs on a graph large enough for
+    // threads and bottom-up steps, with some vertex slots freed
+    printf("\nTesting parallel_bfs():\n");
+    int pn = 100000, pi, pj;
+    struct graph *pg = new_graph();
+    struct map **pv = malloc(pn * sizeof(struct map *));
+    struct map **pfrom = malloc(pn * sizeof(struct map *));
+    struct map **pto = malloc(pn * sizeof(struct map *));
+    char **pdata = malloc(pn * sizeof(char *));
+    unsigned int seed = 12345;
+    for (pi = 0; pi < pn; ++pi) {
+        pv[pi] = make_map();
+        add_vertex(pg, pv[pi]);
+        pdata[pi] = "";
+    }
+    // pass pj links each vertex into the pj-th band of later ids
+    for (pj = 0; pj < 6; ++pj) {
+        for (pi = 0; pi < pn; ++pi) {
+            seed = seed * 1103515245 + 12345;
+            pfrom[pi] = pv[pi];
+            pto[pi] = pv[(pi + 1 + pj * (pn / 6) + (seed >> 8) % (pn / 6 - 1)) % pn];
+        }
+        add_batch(pg, pfrom, pdata, pto, pn);
+    }
+    for (pi = 7; pi < pn; pi += 97) {
+        delete_vertex(pg, pv[pi]);
+    }
+
+    struct traversal *st = bfs(pg, pv[0]);
+    int threads;
+    for (threads = 1; threads <= 4; threads *= 2) {
+        graph_set_threads(threads);
+        struct traversal *pt = parallel_bfs(pg, pv[0]);
+        int bad = pt->count != st->count;
+        for (pi = 0; pi < pg->vertex_slots; ++pi) {
+            if (pt->depth[pi] != st->depth[pi])
+                ++bad;
+            // a parent is one level up and has an edge to the vertex
+            else if (pt->depth[pi] > 0) {
+                int parent = pt->parent[pi];
+                if (parent < 0 || pt->depth[parent] != pt->depth[pi] - 1
+                        || !_find_edge(pg, pg->vertices[parent].data, pg->vertices[pi].data))
+                    ++bad;
+            }
+        }
+        printf("%d thread(s): %d reached, %d mismatches\n", threads, pt->count, bad);
+        free_traversal(pt);
+    }
+    graph_set_threads(1);
+    free_traversal(st);
+
 
 
 